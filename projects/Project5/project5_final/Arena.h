@@ -0,0 +1,124 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Bump allocator for the short-lived relations of one rule evaluation.
+// Small allocations (the tuples) advance a pointer through large blocks,
+// freeing them does nothing (except for the most recent one, which is
+// handed back), and reset() rewinds all of it at once. Blocks are kept,
+// so evaluating the same rule again does not go back to the heap. Large
+// allocations, the row and hash arrays of a set, go to the heap as usual:
+// they are few, and a growing array would otherwise strand every buffer it
+// outgrew.
+//
+// Not thread-safe: an arena serves one evaluation on one thread at a time.
+class Arena : public pmr::memory_resource
+{
+private:
+    static constexpr size_t BLOCK_SIZE = 64 << 10;
+    static constexpr size_t MAX_BLOCK_SIZE = 64 << 20;
+    static constexpr size_t LARGE_SIZE = 16 << 10;
+
+    vector<pair<char*, size_t>> blocks; // (memory, size)
+    size_t block = 0;                   // block being bumped
+    size_t used = 0;                    // bytes taken from it
+    void* last = nullptr;               // most recent allocation
+
+    static Arena*& active()
+    {
+        static thread_local Arena* arena = nullptr;
+        return arena;
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (bytes >= LARGE_SIZE) return ::operator new(bytes, align_val_t(alignment));
+        while (block < blocks.size())
+        {
+            uintptr_t base = reinterpret_cast<uintptr_t>(blocks[block].first);
+            uintptr_t start = (base + used + alignment - 1) & ~(uintptr_t(alignment) - 1);
+            if (start + bytes <= base + blocks[block].second)
+            {
+                used = start + bytes - base;
+                last = reinterpret_cast<void*>(start);
+                return last;
+            }
+            block++;
+            used = 0;
+        }
+        size_t size = blocks.empty() ? BLOCK_SIZE : min(blocks.back().second * 2, MAX_BLOCK_SIZE);
+        blocks.emplace_back(static_cast<char*>(::operator new(size)), size);
+        block = blocks.size() - 1;
+        used = 0;
+        return do_allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        if (bytes >= LARGE_SIZE)
+        {
+            ::operator delete(p, align_val_t(alignment));
+            return;
+        }
+        // A tuple built and then found to be a duplicate is freed right away
+        if (p == last && block < blocks.size())
+        {
+            used = static_cast<char*>(p) - blocks[block].first;
+            last = nullptr;
+        }
+    }
+
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+public:
+    Arena() {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena()
+    {
+        for (const auto& b : blocks) ::operator delete(b.first);
+    }
+
+    // Everything allocated so far becomes invalid; large allocations must
+    // have been freed already
+    void reset()
+    {
+        block = 0;
+        used = 0;
+        last = nullptr;
+    }
+
+    // Arena of the innermost ArenaScope on this thread, else the heap
+    static pmr::memory_resource* current()
+    {
+        Arena* arena = active();
+        return arena ? static_cast<pmr::memory_resource*>(arena) : pmr::get_default_resource();
+    }
+
+    friend class ArenaScope;
+};
+
+// Makes an arena the one relational operators on this thread build their
+// results in, until the scope ends
+class ArenaScope
+{
+private:
+    Arena* saved;
+
+public:
+    explicit ArenaScope(Arena& arena) : saved(Arena::active()) { Arena::active() = &arena; }
+    ~ArenaScope() { Arena::active() = saved; }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+};
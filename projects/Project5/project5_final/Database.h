@@ -4,7 +4,9 @@
 #include "Relation.h"
 #include "Tuple.h"
 #include "Scheme.h"
+#include "SymbolTable.h"
 #include <map>
+#include <set>
 #include <string>
 
 
@@ -16,7 +18,9 @@ class Database
    Database(){}
    void addRelation(const Relation& relation)
    {
-        relations[relation.getName()] = relation;
+        Relation& stored = relations[relation.getName()];
+        stored.enableIndexes();
+        stored = relation;
    }
    bool hasRelation(const string& name)
    {
@@ -24,7 +28,8 @@ class Database
    }
    void createRelation(const string& name, const Scheme& scheme)
    {
-    relations.emplace(name, Relation(name, scheme));
+    auto inserted = relations.emplace(name, Relation(name, scheme));
+    if (inserted.second) inserted.first->second.enableIndexes();
    }
 
    Relation& getRelation(const string& name)
@@ -38,11 +43,96 @@ class Database
         return it->second;
     }
 
+    // Inserts into a relation and, if that relation is being tracked,
+    // appends the tuple to its delta log
+    bool addTuple(const string& name, const Tuple& tuple)
+    {
+        if (!relations.at(name).addTuple(tuple)) return false;
+        auto it = deltaLogs.find(name);
+        if (it != deltaLogs.end() && it->second.tracking) it->second.tuples.push_back(tuple);
+        return true;
+    }
+
+    // Deletions are not logged; callers track what they remove
+    bool eraseTuple(const string& name, const Tuple& tuple)
+    {
+        return relations.at(name).eraseTuple(tuple);
+    }
+
+    // Create (untracked) logs up front. Tracking and clearing existing logs
+    // leaves the map alone, so SCCs with disjoint heads can do it from
+    // different threads.
+    void reserveDeltas(const set<string>& names)
+    {
+        for (const auto& name : names) deltaLogs[name];
+    }
+
+    // Start recording new tuples for the given relations (one SCC's heads)
+    void trackDeltas(const set<string>& names)
+    {
+        for (const auto& name : names)
+        {
+            DeltaLog& log = deltaLogs[name];
+            log.tracking = true;
+            log.tuples.clear();
+        }
+    }
+
+    void clearDeltas(const set<string>& names)
+    {
+        for (const auto& name : names)
+        {
+            auto it = deltaLogs.find(name);
+            if (it == deltaLogs.end()) continue;
+            it->second.tracking = false;
+            it->second.tuples.clear();
+        }
+    }
+
+    void clearDeltas()
+    {
+        deltaLogs.clear();
+    }
+
+    // Position in a relation's delta log; 0 if it is not tracked
+    size_t deltaMark(const string& name) const
+    {
+        auto it = deltaLogs.find(name);
+        return it == deltaLogs.end() || !it->second.tracking ? 0 : it->second.tuples.size();
+    }
 
+    // Tuples added to a relation since the given mark
+    Relation getDelta(const string& name, size_t mark) const
+    {
+        const Relation& total = getRelation(name);
+        Relation delta(total.getName(), total.getScheme(), Arena::current());
+        auto it = deltaLogs.find(name);
+        if (it == deltaLogs.end() || !it->second.tracking) return delta;
+        const vector<Tuple>& log = it->second.tuples;
+        for (size_t i = mark; i < log.size(); i++) delta.addTuple(log[i]);
+        return delta;
+    }
 
+    // Total tuples across every relation
+    size_t tupleCount() const
+    {
+        size_t count = 0;
+        for (const auto& pair : relations) count += pair.second.size();
+        return count;
+    }
 
+    SymbolTable& getSymbols() { return symbols; }
+    const SymbolTable& getSymbols() const { return symbols; }
 
    private:
     map<string,Relation>relations;
+    SymbolTable symbols;
+
+    struct DeltaLog
+    {
+        bool tracking = false;
+        vector<Tuple> tuples; // new tuples, in insertion order
+    };
+    map<string,DeltaLog> deltaLogs;
 
 };
\ No newline at end of file
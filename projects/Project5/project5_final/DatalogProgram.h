@@ -4,8 +4,22 @@
 #include "Predicate.h"
 #include "Rule.h"
 #include <set>
+#include <map>
+#include <string_view>
 using namespace std;
 
+// Facts of one relation and arity stored flat, without a Predicate per fact.
+// Values are the quoted token text and point into the scanner's source
+// buffer, so that buffer must outlive the program.
+struct FactBatch
+{
+   string name;
+   size_t arity;
+   vector<string_view> values;
+
+   size_t size() const { return arity == 0 ? 0 : values.size() / arity; }
+};
+
 
 class DatalogProgram
 {
@@ -15,29 +29,41 @@ public:
 
    void addScheme(Predicate scheme)
    {
-      this->schemes.push_back(scheme);
+      this->schemes.push_back(std::move(scheme));
    }
 
    void addFact(Predicate fact)
    {
-      this->facts.push_back(fact);
-      for (Parameter& param : fact.getParameters())
+      this->facts.push_back(std::move(fact));
+   }
+
+   // Bulk path used by the parser: append one fact's values to its batch
+   void addFactValues(string_view name, const vector<string_view>& values)
+   {
+      auto key = make_pair(string(name), values.size());
+      auto it = batchIndex.find(key);
+      if (it == batchIndex.end())
       {
-         if (!param.getIsID())
-         {
-            domain.insert(param.getValue());
-         }
+         it = batchIndex.emplace(key, factBatches.size()).first;
+         factBatches.push_back(FactBatch{key.first, key.second, {}});
       }
+      vector<string_view>& dest = factBatches[it->second].values;
+      dest.insert(dest.end(), values.begin(), values.end());
    }
 
    void addRule(Rule rule)
    {
-      this->rules.push_back(rule);
+      this->rules.push_back(std::move(rule));
+   }
+
+   void clearRules()
+   {
+      this->rules.clear();
    }
 
    void addQuery(Predicate query)
    {
-      this->queries.push_back(query);
+      this->queries.push_back(std::move(query));
    }
 
    string toString()
@@ -48,11 +74,25 @@ public:
       {
          ss << " " << scheme.toString() << "\n";
       }
-      ss << "Facts(" << facts.size() <<"):\n";
+      size_t factCount = facts.size();
+      for (const FactBatch& batch : factBatches) factCount += batch.size();
+      ss << "Facts(" << factCount <<"):\n";
       for (Predicate& facts : facts)
       {
          ss << " " << facts.toString() << ".\n";
       }
+      for (const FactBatch& batch : factBatches)
+      {
+         for (size_t i = 0; i < batch.values.size(); i += batch.arity)
+         {
+            ss << " " << batch.name << "(";
+            for (size_t j = 0; j < batch.arity; j++)
+            {
+               ss << batch.values[i + j] << (j < batch.arity - 1 ? "," : "");
+            }
+            ss << ").\n";
+         }
+      }
       ss << "Rules(" << rules.size() <<"):\n";
       for (Rule& rules : rules)
       {
@@ -63,6 +103,7 @@ public:
          {
             ss << " " << queries.toString() << "?\n";
          }
+      set<string> domain = getDomain();
       ss << "Domain(" << domain.size() <<"):\n";
       for ( const string& str : domain)
       {
@@ -87,11 +128,36 @@ public:
         return queries;
     }
 
+    const vector<FactBatch>& getFactBatches() const {
+        return factBatches;
+    }
+
+    // Every constant appearing in a fact; computed on demand
+    set<string> getDomain() const {
+        set<string> domain;
+        for (const Predicate& fact : facts)
+        {
+           for (const Parameter& param : fact.getParameters())
+           {
+              if (!param.getIsID())
+              {
+                 domain.insert(param.getValue());
+              }
+           }
+        }
+        for (const FactBatch& batch : factBatches)
+        {
+           for (string_view value : batch.values) domain.insert(string(value));
+        }
+        return domain;
+    }
+
 private:
    vector<Predicate> schemes;
    vector<Predicate> facts;
    vector<Rule> rules;
    vector<Predicate> queries;
-   set<string> domain;
+   vector<FactBatch> factBatches;
+   map<pair<string, size_t>, size_t> batchIndex; // (name, arity) -> factBatches slot
 
 };
\ No newline at end of file
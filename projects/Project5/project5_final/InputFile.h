@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Read-only view of an input file. Regular files are memory-mapped so the
+// scanner reads the page cache directly; pipes and stdin ("-") fall back to
+// buffered reads into an owned string.
+class InputFile
+{
+private:
+    const char* mapped = nullptr;
+    size_t mappedSize = 0;
+    string buffer;
+    bool ok = false;
+
+    void readAll(int fd)
+    {
+        char chunk[1 << 16];
+        ssize_t n;
+        while ((n = ::read(fd, chunk, sizeof(chunk))) > 0)
+        {
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        ok = n == 0;
+    }
+
+public:
+    explicit InputFile(const string& path)
+    {
+        if (path == "-")
+        {
+            readAll(STDIN_FILENO);
+            return;
+        }
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+        {
+            void* addr = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED)
+            {
+                ::madvise(addr, info.st_size, MADV_SEQUENTIAL);
+                mapped = static_cast<const char*>(addr);
+                mappedSize = info.st_size;
+                ok = true;
+            }
+        }
+        if (!ok) readAll(fd);
+        ::close(fd);
+    }
+
+    ~InputFile()
+    {
+        if (mapped) ::munmap(const_cast<char*>(mapped), mappedSize);
+    }
+
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+
+    bool isOpen() const { return ok; }
+
+    string_view view() const
+    {
+        return mapped ? string_view(mapped, mappedSize) : string_view(buffer);
+    }
+};
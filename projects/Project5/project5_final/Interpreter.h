@@ -7,182 +7,259 @@
 #include <vector>
 #include <sstream>
 #include <set>
+#include <string_view>
+#include <unordered_map>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <memory>
 #include "graph.h"
+#include "Arena.h"
+#include "Profiler.h"
+#include "LeapfrogJoin.h"
+#include "MagicSets.h"
+#include "ThreadPool.h"
 
 class Interpreter {
 private:
     DatalogProgram program;
     Database db;
+    bool semiNaive = true;
+    Profiler profiler;
+    std::unique_ptr<ThreadPool> pool; // null when running on one thread
+    bool parallelRules = false;
+    JoinMethod joinMethod = JOIN_AUTO;
+    bool reorderJoins = true;
+    bool leapfrog = true;
+    bool magicSets = false;
+    std::vector<std::string> queryRelations; // relation answering each query
+    std::vector<std::vector<int>> sccOrder; // rule indices per SCC, in evaluation order
+    std::set<std::string> derivedRelations; // heads of some rule
+    std::map<std::string, TupleSet> derivedFacts; // facts given for derived relations
 
 public:
     explicit Interpreter(const DatalogProgram& prog) : program(prog) {}
+    explicit Interpreter(DatalogProgram&& prog) : program(std::move(prog)) {}
+
+    // Naive mode re-joins the full relations on every pass
+    void setSemiNaive(bool enabled) { semiNaive = enabled; }
+
+    void setJoinMethod(JoinMethod method) { joinMethod = method; }
+
+    // When off, body predicates are joined in the order they are written
+    void setJoinReordering(bool enabled) { reorderJoins = enabled; }
+
+    // Use leapfrog triejoin for bodies whose join hypergraph is cyclic
+    void setLeapfrog(bool enabled) { leapfrog = enabled; }
+
+    // Rewrite the rules with magic sets so only facts the queries can
+    // reach are derived. Query answers are unchanged; the rule evaluation
+    // output shows the rewritten rules.
+    void setMagicSets(bool enabled) { magicSets = enabled; }
+
+    // Worker threads for evaluating independent SCCs side by side and for
+    // large hash joins; the output is the same for any count. Profiling
+    // keeps SCCs on one thread.
+    void setThreads(size_t count) { pool.reset(count > 1 ? new ThreadPool(count) : nullptr); }
+
+    // Evaluate the rules of one SCC pass concurrently against the state at
+    // the start of the pass (needs more than one thread). The output stays
+    // deterministic but may take more passes than the in-order default,
+    // where a rule already sees what earlier rules of the same pass added.
+    void setParallelRules(bool enabled) { parallelRules = enabled; }
+
+    void enableProfiling() { profiler.enable(); }
+    const Profiler& getProfiler() const { return profiler; }
+    const Database& getDatabase() const { return db; }
 
     void run() {
+        if (magicSets) program = MagicSets(program).rewrite(queryRelations);
         std::cout << "Dependency Graph" << std::endl;
         evaluateSchemes();
+        for (const auto& rule : program.getRules()) {
+            derivedRelations.insert(rule.getHeadPredicate().getName());
+        }
         evaluateFacts();
         Graph DependencyGraph = makeGraph(program.getRules());
         Graph ReverseGraph = DependencyGraph.reversegraph();
         std::stack<int> postOrder = ReverseGraph.dfsForestPostOrder();
         std::vector<std::set<int>> SCCs = DependencyGraph.findSCCs(postOrder);
+        for (const auto& scc : SCCs) sccOrder.emplace_back(scc.begin(), scc.end());
         evaluateRulesWithSCC(SCCs);
         evaluateQueries();
     }
 
+    // Incremental maintenance after run(): retract the facts of `removed`
+    // and add those of `added`, updating only their consequences SCC by
+    // SCC, then answer the queries again
+    void update(const DatalogProgram& added, const DatalogProgram& removed = DatalogProgram()) {
+        if (retractFacts(removed) > 0) propagate();
+        if (insertFacts(added) > 0) propagate();
+        evaluateQueries();
+    }
+
     void evaluateRulesWithSCC(const std::vector<std::set<int>>& SCCs) 
     {
         std::cout << "Rule Evaluation" << std::endl;
-        for (const auto& scc : SCCs)
+        if (pool && !profiler.isEnabled() && SCCs.size() > 1) {
+            evaluateSCCsInParallel(SCCs);
+            return;
+        }
+        for (size_t i = 0; i < SCCs.size(); i++)
         {
-            std::vector<int> sccVector(scc.begin(), scc.end());
-            std::sort(sccVector.begin(), sccVector.end());
-            std::cout << "SCC: ";
-            for (size_t i = 0; i < sccVector.size(); i++)
+            evaluateSCC(i + 1, SCCs[i], std::cout);
+        }
+    }
+
+    // Evaluate one SCC to fixpoint, writing its section of the output
+    void evaluateSCC(int sccNumber, const std::set<int>& scc, std::ostream& out)
+    {
+        std::vector<int> sccVector(scc.begin(), scc.end());
+        std::sort(sccVector.begin(), sccVector.end());
+        out << "SCC: ";
+        for (size_t i = 0; i < sccVector.size(); i++)
+        {
+            out <<"R" << sccVector[i];
+            if (i < sccVector.size() - 1)
             {
-                std::cout <<"R" << sccVector[i];
-                if (i < sccVector.size() - 1)
-                {
-                    std::cout << ",";
-                }
-                else 
-                {
-                    std::cout << "" << std::endl;
-                }
+                out << ",";
+            }
+            else 
+            {
+                out << "" << std::endl;
             }
+        }
 
-            bool triv = sccVector.size() == 1;
+        bool triv = sccVector.size() == 1;
+        
+        // see if trivial SCC (single rule) that doesn't depend on itself
+        bool selfDependent = false;
+        if (triv) {
+            int ruleIndex = sccVector[0];
+            const Rule& rule = program.getRules()[ruleIndex];
             
-            // see if trivial SCC (single rule) that doesn't depend on itself
-            bool selfDependent = false;
-            if (triv) {
-                int ruleIndex = sccVector[0];
-                const Rule& rule = program.getRules()[ruleIndex];
-                
-                // Check if this rule depends on itself
-                for (const auto& bodyPred : rule.getBodyPredicates()) {
-                    if (bodyPred.getName() == rule.getHeadPredicate().getName()) {
-                        selfDependent = true;
-                        break;
-                    }
+            // Check if this rule depends on itself
+            for (const auto& bodyPred : rule.getBodyPredicates()) {
+                if (bodyPred.getName() == rule.getHeadPredicate().getName()) {
+                    selfDependent = true;
+                    break;
                 }
             }
+        }
+        
+        // For single rule SCC that doesn't depend on itself
+        if (triv && !selfDependent)
+        {
+            int ruleIndex = sccVector[0];
+            const Rule& rule = program.getRules()[ruleIndex];
             
-            // For single rule SCC that doesn't depend on itself
-            if (triv && !selfDependent)
-            {
-                int ruleIndex = sccVector[0];
-                const Rule& rule = program.getRules()[ruleIndex];
-                
-                // Print the rule
-                std::cout << rule.toString() << "." << std::endl;
-                
-                // Evaluate the rule once without fixed-point
-                std::vector<Relation> intermediates;
-                
-                // Process body predicates
-                for (const auto& bodyPred : rule.getBodyPredicates()) {
-                    Relation r = db.getRelation(bodyPred.getName());
-                    auto params = bodyPred.getParameters();
-
-                    std::map<std::string, int> varIndices;
-                    std::vector<size_t> projectIndices;
-                    std::vector<std::string> renameAttrs;
-
-                    for (size_t i = 0; i < params.size(); ++i) {
-                        const auto& param = params[i];
-                        if (!param.getIsID()) {
-                            std::string value = param.getValue();
-                            if (value.size() >= 2 && value.front() == '\'' && value.back() == '\'') {
-                                value = value.substr(1, value.size() - 2);
-                            }
-                            r = r.select(i, value);
-                        } else {
-                            const std::string& varName = param.getValue();
-                            if (varIndices.find(varName) != varIndices.end()) {
-                                r = r.select(varIndices[varName], i);
-                            } else {
-                                varIndices[varName] = i;
-                                projectIndices.push_back(i);
-                                renameAttrs.push_back(varName);
-                            }
-                        }
-                    }
-
-                    r = r.project(projectIndices);
-                    r = r.rename(renameAttrs);
-                    intermediates.push_back(r);
+            // Print the rule
+            out << rule.toString() << "." << std::endl;
+            
+            // Evaluate the rule once without fixed-point
+            profiler.beginRule(sccNumber, ruleIndex, 1);
+            if (!rule.getBodyPredicates().empty()) {
+                Arena arena;
+                {
+                    ArenaScope scope(arena);
+                    addRuleResult(rule, evaluateBody(rule, {}), &out);
                 }
+                arena.reset();
+            }
+            profiler.endRule(0); // no-op if addRuleResult closed it
+            
+            // For trivial non-recursive SCCs
+            out << "1 passes: ";
+            out << "R" << ruleIndex;
+        } 
+        else {
+            // For multiple rule SCCs/self-dependent SCCs
+            int rulePasses = evaluateRules(sccVector, true, out, sccNumber);
+            int totalPasses = rulePasses + 1; //add 1
+            
+            out << totalPasses << " passes: ";
+            for (size_t i = 0; i < sccVector.size(); i++)
+            {
+                out << "R" << sccVector[i] << (i < sccVector.size() - 1 ? "," : "");
+            }
+            out << "\n";
+        }
 
-                if (!intermediates.empty()) {
-                    Relation result = intermediates[0];
-                    for (size_t i = 1; i < intermediates.size(); ++i) {
-                        result = result.join(intermediates[i]);
-                    }
-
-                    // Process head-predicate
-                    const auto& headPredicate = rule.getHeadPredicate();
-                    std::vector<size_t> headProjectIndices;
-                    std::vector<std::string> outputVarNames;
+        out << "\n";
+    }
 
-                    for (const auto& headParam : headPredicate.getParameters()) {
-                        outputVarNames.push_back(headParam.getValue());
-                    }
+    // Condensation DAG scheduling: an SCC is forked on the pool once every
+    // SCC it reads from is done. Each SCC writes into its own buffer and
+    // the buffers are printed in the original order as they complete.
+    void evaluateSCCsInParallel(const std::vector<std::set<int>>& SCCs)
+    {
+        const std::vector<Rule>& rules = program.getRules();
+        std::vector<size_t> sccOf(rules.size());
+        for (size_t i = 0; i < SCCs.size(); i++) {
+            for (int ruleIndex : SCCs[i]) sccOf[ruleIndex] = i;
+        }
+        std::map<std::string, std::vector<size_t>> headSCCs;
+        for (size_t r = 0; r < rules.size(); r++) {
+            headSCCs[rules[r].getHeadPredicate().getName()].push_back(sccOf[r]);
+        }
 
-                    // Find position of head variables in the results scheme
-                    for (const auto& varName : outputVarNames) {
-                        for (size_t i = 0; i < result.getScheme().size(); ++i) {
-                            if (result.getScheme()[i] == varName) {
-                                headProjectIndices.push_back(i);
-                                break;
-                            }
-                        }
+        std::vector<std::set<size_t>> dependents(SCCs.size());
+        std::vector<size_t> waitingOn(SCCs.size(), 0);
+        for (size_t i = 0; i < SCCs.size(); i++) {
+            // Wait for every SCC writing a relation this one reads, and for
+            // earlier SCCs writing the same head so new tuples are
+            // attributed to the same rules as in a serial run
+            std::set<size_t> sources;
+            for (int ruleIndex : SCCs[i]) {
+                for (const auto& bodyPred : rules[ruleIndex].getBodyPredicates()) {
+                    auto it = headSCCs.find(bodyPred.getName());
+                    if (it == headSCCs.end()) continue;
+                    for (size_t source : it->second) {
+                        if (source != i) sources.insert(source);
                     }
+                }
+                for (size_t source : headSCCs[rules[ruleIndex].getHeadPredicate().getName()]) {
+                    if (source < i) sources.insert(source);
+                }
+            }
+            waitingOn[i] = sources.size();
+            for (size_t source : sources) dependents[source].insert(i);
+        }
 
-                    result = result.project(headProjectIndices);
-
-                    // Rename to match the TARGET relation's scheme
-                    Relation& target = db.getRelation(headPredicate.getName());
-                    result = result.rename(target.getScheme());
+        // Every head's delta log exists before any worker starts, so
+        // tracking and clearing them never changes the log map itself
+        db.reserveDeltas(derivedRelations);
 
-                    // Collect new tuples and print using TARGET's scheme
-                    std::vector<Tuple> newTuples;
-                    for (const auto& t : result.getTuples()) {
-                        if (target.addTuple(t)) {
-                            newTuples.push_back(t);
-                        }
-                    }
+        std::vector<std::ostringstream> buffers(SCCs.size());
+        std::vector<bool> done(SCCs.size(), false);
+        std::mutex lock;
+        std::condition_variable finished;
+        TaskGroup group(*pool);
 
-                    // Print tuples with TARGET's attribute names
-                    const Scheme& targetScheme = target.getScheme();
-                    for (const auto& t : newTuples) {
-                        std::cout << "  ";
-                        for (size_t i = 0; i < targetScheme.size(); ++i) {
-                            std::cout << targetScheme[i] << "='" << t[i] << "'";
-                            if (i < targetScheme.size() - 1) std::cout << ", ";
-                        }
-                        std::cout << std::endl;
-                    }
-                }
-                
-                // For trivial non-recursive SCCs
-                std::cout << "1 passes: ";
-                std::cout << "R" << ruleIndex;
-            } 
-            else {
-                // For multiple rule SCCs/self-dependent SCCs
-                int rulePasses = evaluateRules(sccVector, true);
-                int totalPasses = rulePasses + 1; //add 1
-                
-                std::cout << totalPasses << " passes: ";
-                for (size_t i = 0; i < sccVector.size(); i++)
-                {
-                    std::cout << "R" << sccVector[i] << (i < sccVector.size() - 1 ? "," : "");
-                }
-                std::cout << "\n";
+        std::function<void(size_t)> runSCC = [&](size_t i) {
+            evaluateSCC(i + 1, SCCs[i], buffers[i]);
+            std::lock_guard<std::mutex> guard(lock);
+            done[i] = true;
+            for (size_t next : dependents[i]) {
+                if (--waitingOn[next] == 0) group.run([&runSCC, next] { runSCC(next); });
             }
+            finished.notify_one();
+        };
+        std::vector<size_t> ready;
+        for (size_t i = 0; i < SCCs.size(); i++) {
+            if (waitingOn[i] == 0) ready.push_back(i);
+        }
+        for (size_t i : ready) group.run([&runSCC, i] { runSCC(i); });
 
-            std::cout << "\n";
+        for (size_t i = 0; i < SCCs.size(); i++) {
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                finished.wait(guard, [&] { return done[i]; });
+            }
+            std::cout << buffers[i].str();
+            buffers[i] = std::ostringstream();
         }
+        group.wait();
     }
 
     static Graph makeGraph(const std::vector<Rule>& rules)
@@ -247,7 +324,7 @@ private:
     void evaluateSchemes() {
         for (const auto& scheme : program.getSchemes()) {
             std::vector<std::string> attributes;
-            auto params = scheme.getParameters();
+            const auto& params = scheme.getParameters();
             for (const auto& param : params) {
                 attributes.push_back(param.getValue());
             }
@@ -255,53 +332,78 @@ private:
         }
     }
 
+    static std::string_view stripQuotes(std::string_view value) {
+        if (value.size() >= 2 && value.front() == '\'' && value.back() == '\'') {
+            return value.substr(1, value.size() - 2);
+        }
+        return value;
+    }
+
     void evaluateFacts() {
+        // Intern every constant in sorted order first so symbol ids compare
+        // the same way the strings do. Values repeat a lot, so they are
+        // deduplicated through the map before only the distinct ones are sorted.
+        std::unordered_map<std::string_view, Symbol> ids;
         for (const auto& fact : program.getFacts()) {
-            std::vector<std::string> values;
-            auto params = fact.getParameters();
-            for (const auto& param : params) {
-                std::string val = param.getValue();
-                if (val.size() >= 2 && val.front() == '\'' && val.back() == '\'') {
-                    val = val.substr(1, val.size() - 2);
+            for (const auto& param : fact.getParameters()) {
+                ids.emplace(stripQuotes(std::string_view(param.getValue())), 0);
+            }
+        }
+        for (const auto& batch : program.getFactBatches()) {
+            for (std::string_view value : batch.values) {
+                ids.emplace(stripQuotes(value), 0);
+            }
+        }
+        std::vector<std::string_view> constants;
+        constants.reserve(ids.size());
+        for (const auto& entry : ids) constants.push_back(entry.first);
+        std::sort(constants.begin(), constants.end());
+
+        SymbolTable& symbols = db.getSymbols();
+        for (std::string_view constant : constants) {
+            ids[constant] = symbols.intern(std::string(constant));
+        }
+
+        for (const auto& fact : program.getFacts()) {
+            std::vector<Symbol> values;
+            for (const auto& param : fact.getParameters()) {
+                values.push_back(ids.at(stripQuotes(std::string_view(param.getValue()))));
+            }
+            addFact(fact.getName(), Tuple(values));
+        }
+
+        for (const auto& batch : program.getFactBatches()) {
+            Relation& relation = db.getRelation(batch.name);
+            bool derived = derivedRelations.count(batch.name) > 0;
+            for (size_t i = 0; i < batch.values.size(); i += batch.arity) {
+                Tuple tuple;
+                tuple.reserve(batch.arity);
+                for (size_t j = 0; j < batch.arity; ++j) {
+                    tuple.push_back(ids.at(stripQuotes(batch.values[i + j])));
                 }
-                values.push_back(val);
+                if (derived) derivedFacts[batch.name].insert(tuple);
+                relation.addTuple(tuple);
             }
-            db.getRelation(fact.getName()).addTuple(Tuple(values));
         }
     }
 
+    // Facts of a derived relation are also kept aside, so that deleting a
+    // derivation does not delete a tuple that was given as a fact
+    bool addFact(const std::string& name, const Tuple& tuple) {
+        if (derivedRelations.count(name)) derivedFacts[name].insert(tuple);
+        return db.addTuple(name, tuple);
+    }
+
     void evaluateQueries() {
         std::cout << std::endl;
         std::cout << "Query Evaluation" << std::endl;
-        for (const auto& query : program.getQueries()) {
-            Relation result = db.getRelation(query.getName());
-            std::map<std::string, int> varPositions;
-            std::vector<size_t> projectIndices;
-            std::vector<std::string> renameList;
-
-            auto params = query.getParameters();
-            for (size_t i = 0; i < params.size(); ++i) {
-                const auto& param = params[i];
-                if (!param.getIsID()) {
-                    std::string value = param.getValue();
-                    if (value.size() >= 2 && value.front() == '\'' && value.back() == '\'') {
-                        value = value.substr(1, value.size() - 2);
-                    }
-                    result = result.select(i, value);
-                } else {
-                    const std::string& varName = param.getValue();
-                    if (varPositions.find(varName) != varPositions.end()) {
-                        result = result.select(varPositions[varName], i);
-                    } else {
-                        varPositions[varName] = i;
-                        projectIndices.push_back(i);
-                        renameList.push_back(varName);
-                    }
-                }
-            }
-
-            result = result.project(projectIndices);
-            result = result.rename(renameList);
+        const std::vector<Predicate>& queries = program.getQueries();
+        for (size_t q = 0; q < queries.size(); q++) {
+            const Predicate& query = queries[q];
+            Predicate target = query;
+            if (!queryRelations.empty()) target.setName(queryRelations[q]);
+            Relation result = evaluatePredicate(target);
+            const Scheme& renameList = result.getScheme();
 
             std::cout << query.toString() << "? ";
             if (result.getTuples().empty()) {
@@ -309,12 +411,14 @@ private:
             } else {
                 std::cout << "Yes(" << result.getTuples().size() << ")" << std::endl;
                 std::vector<Tuple> sortedTuples(result.getTuples().begin(), result.getTuples().end());
-                std::sort(sortedTuples.begin(), sortedTuples.end());
+                const SymbolTable& symbols = db.getSymbols();
+                std::sort(sortedTuples.begin(), sortedTuples.end(),
+                          [&](const Tuple& a, const Tuple& b) { return symbols.less(a, b); });
 
                 for (const auto& t : sortedTuples) {
                     std::cout << "  ";
                     for (size_t i = 0; i < renameList.size(); ++i) {
-                        std::cout << renameList[i] << "='" << t[i] << "'";
+                        std::cout << renameList[i] << "='" << symbols.name(t[i]) << "'";
                         if (i < renameList.size() - 1) std::cout << ", ";
                     }
                     std::cout << std::endl;
@@ -323,7 +427,544 @@ private:
         }
     }
 
-    int evaluateRules(const std::vector<int>& ruleIndices = std::vector<int>(), bool printRules = true) {
+    // Filters and output columns for one body predicate or query
+    struct ScanPlan {
+        std::vector<std::pair<size_t, Symbol>> constants;
+        std::vector<std::pair<size_t, size_t>> equalities;
+        std::vector<size_t> projectIndices;
+        std::vector<std::string> renameAttrs;
+        bool satisfiable = true; // false if a constant is in no fact
+    };
+
+    ScanPlan planScan(const Predicate& pred) const {
+        const auto& params = pred.getParameters();
+        ScanPlan plan;
+        std::map<std::string, size_t> varIndices;
+
+        for (size_t i = 0; i < params.size(); ++i) {
+            const auto& param = params[i];
+            if (!param.getIsID()) {
+                Symbol value;
+                if (db.getSymbols().lookup(std::string(stripQuotes(std::string_view(param.getValue()))), value)) {
+                    plan.constants.emplace_back(i, value);
+                } else {
+                    plan.satisfiable = false;
+                }
+            } else {
+                const std::string& varName = param.getValue();
+                auto it = varIndices.find(varName);
+                if (it != varIndices.end()) {
+                    plan.equalities.emplace_back(it->second, i);
+                } else {
+                    varIndices[varName] = i;
+                    plan.projectIndices.push_back(i);
+                    plan.renameAttrs.push_back(varName);
+                }
+            }
+        }
+        return plan;
+    }
+
+    // Select, project and rename one body predicate or query against a
+    // relation in a single fused scan
+    Relation evaluatePredicate(const Predicate& pred, const Relation& source) {
+        ScanPlan plan = planScan(pred);
+        if (!plan.satisfiable) return Relation(source.getName(), Scheme(plan.renameAttrs));
+        return profiler.measure(Profiler::SCAN, [&] {
+            return source.scan(plan.constants, plan.equalities, plan.projectIndices, Scheme(plan.renameAttrs));
+        });
+    }
+
+    // Same, against the stored relation named by the predicate
+    Relation evaluatePredicate(const Predicate& pred) {
+        return evaluatePredicate(pred, db.getRelation(pred.getName()));
+    }
+
+    static bool sharesAttribute(const Scheme& a, const Scheme& b) {
+        for (const auto& attr : a) {
+            if (std::find(b.begin(), b.end(), attr) != b.end()) return true;
+        }
+        return false;
+    }
+
+    // Greedy left-deep join order: start from the smallest input, then keep
+    // adding the smallest input that shares a variable with what has been
+    // joined so far. An unconnected input is only taken when nothing
+    // connected is left, so cartesian products are avoided whenever a
+    // connected order exists. Cheap enough to redo on every evaluation,
+    // which lets small semi-naive deltas go first.
+    static std::vector<size_t> joinOrder(const std::vector<RelationView>& inputs) {
+        std::vector<size_t> order;
+        std::vector<bool> used(inputs.size(), false);
+        Scheme joined;
+        for (size_t step = 0; step < inputs.size(); ++step) {
+            size_t best = inputs.size();
+            bool bestConnected = false;
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                if (used[i]) continue;
+                bool connected = step > 0 && sharesAttribute(inputs[i].scheme, joined);
+                if (best == inputs.size() || (connected && !bestConnected) ||
+                    (connected == bestConnected && inputs[i].relation->size() < inputs[best].relation->size())) {
+                    best = i;
+                    bestConnected = connected;
+                }
+            }
+            used[best] = true;
+            order.push_back(best);
+            for (const auto& attr : inputs[best].scheme) {
+                if (std::find(joined.begin(), joined.end(), attr) == joined.end()) joined.push_back(attr);
+            }
+        }
+        return order;
+    }
+
+    // Join the body inputs. The result always has the columns in the order
+    // the written join would give, whatever order was used. The inputs are
+    // only read, so stored relations are joined where they are; a single
+    // input is copied.
+    Relation joinAll(const std::vector<RelationView>& inputs) {
+        if (inputs.size() == 1) {
+            Relation result(inputs[0].relation->getName(), inputs[0].scheme, Arena::current());
+            result.Union(*inputs[0].relation);
+            return result;
+        }
+
+        Scheme canonical;
+        for (const RelationView& r : inputs) {
+            for (const auto& attr : r.scheme) {
+                if (std::find(canonical.begin(), canonical.end(), attr) == canonical.end()) canonical.push_back(attr);
+            }
+        }
+        for (const RelationView& r : inputs) {
+            if (r.relation->getTuples().empty()) return Relation(r.relation->getName(), canonical, Arena::current());
+        }
+
+        if (leapfrog && inputs.size() >= 3 && LeapfrogJoin::pays(inputs)) {
+            std::vector<Scheme> schemes;
+            for (const RelationView& r : inputs) schemes.push_back(r.scheme);
+            if (LeapfrogJoin::isCyclic(schemes)) {
+                return profiler.measure(Profiler::JOIN, [&] { return LeapfrogJoin::join(inputs, canonical); });
+            }
+        }
+
+        std::vector<size_t> order;
+        if (reorderJoins) {
+            order = joinOrder(inputs);
+        } else {
+            for (size_t i = 0; i < inputs.size(); ++i) order.push_back(i);
+        }
+
+        Relation result = profiler.measure(Profiler::JOIN, [&] {
+            return Relation::join(inputs[order[0]], inputs[order[1]], joinMethod, pool.get());
+        });
+        for (size_t k = 2; k < order.size(); ++k) {
+            const RelationView& next = inputs[order[k]];
+            result = profiler.measure(Profiler::JOIN, [&] {
+                return Relation::join(result.view(result.getScheme()), next, joinMethod, pool.get());
+            });
+        }
+
+        if (result.getScheme() != canonical) {
+            std::vector<size_t> columns;
+            for (const auto& attr : canonical) {
+                const Scheme& scheme = result.getScheme();
+                columns.push_back(std::find(scheme.begin(), scheme.end(), attr) - scheme.begin());
+            }
+            result = profiler.measure(Profiler::SCAN, [&] { return std::move(result).scan({}, {}, columns, canonical); });
+        }
+        return result;
+    }
+
+    // One body literal as a join input. A literal of distinct variables
+    // and no constants only renames its relation, so the stored relation
+    // is read as it is; anything else is scanned into `scanned`, which the
+    // caller has reserved room in.
+    RelationView bodyInput(const Predicate& pred, std::vector<Relation>& scanned) {
+        ScanPlan plan = planScan(pred);
+        const Relation& stored = db.getRelation(pred.getName());
+        bool renaming = plan.satisfiable && plan.constants.empty() && plan.equalities.empty() &&
+                        plan.projectIndices.size() == stored.getScheme().size();
+        for (size_t i = 0; renaming && i < plan.projectIndices.size(); ++i) renaming = plan.projectIndices[i] == i;
+        if (renaming) return stored.view(Scheme(plan.renameAttrs));
+        scanned.push_back(evaluatePredicate(pred));
+        return scanned.back().view(scanned.back().getScheme());
+    }
+
+    // Semi-naive body: for each predicate with new tuples since its mark, join
+    // that delta against the totals of the others and union the results.
+    // Anything derivable only from old tuples was already added last time.
+    Relation evaluateDeltaBody(const Rule& rule, const std::vector<size_t>& marks) {
+        const auto& body = rule.getBodyPredicates();
+        std::vector<RelationView> totals;
+        std::vector<Relation> scanned;
+        scanned.reserve(body.size());
+        Relation result("", Scheme(), Arena::current());
+        bool first = true;
+
+        for (size_t i = 0; i < body.size(); ++i) {
+            Relation delta = db.getDelta(body[i].getName(), marks[i]);
+            if (delta.getTuples().empty()) continue;
+
+            if (totals.empty()) {
+                for (const auto& bodyPred : body) {
+                    totals.push_back(bodyInput(bodyPred, scanned));
+                }
+            }
+            Relation deltaScan = evaluatePredicate(body[i], delta);
+            std::vector<RelationView> inputs = totals;
+            inputs[i] = deltaScan.view(deltaScan.getScheme());
+
+            Relation partial = body.size() == 1 ? std::move(deltaScan) : joinAll(inputs);
+            if (first) {
+                result = std::move(partial);
+                first = false;
+            } else {
+                result.Union(std::move(partial));
+            }
+        }
+        return result;
+    }
+
+    // (relation, quoted values) for every fact of an update
+    static std::vector<std::pair<std::string, std::vector<std::string_view>>> collectFacts(const DatalogProgram& update) {
+        std::vector<std::pair<std::string, std::vector<std::string_view>>> facts;
+        for (const auto& fact : update.getFacts()) {
+            std::vector<std::string_view> values;
+            for (const auto& param : fact.getParameters()) values.push_back(param.getValue());
+            facts.emplace_back(fact.getName(), values);
+        }
+        for (const auto& batch : update.getFactBatches()) {
+            for (size_t i = 0; i < batch.values.size(); i += batch.arity) {
+                facts.emplace_back(batch.name, std::vector<std::string_view>(batch.values.begin() + i,
+                                                                             batch.values.begin() + i + batch.arity));
+            }
+        }
+        return facts;
+    }
+
+    bool knownRelation(const std::string& name, size_t arity) {
+        if (db.hasRelation(name) && db.getRelation(name).getScheme().size() == arity) return true;
+        std::cerr << "Unknown relation: " << name << "/" << arity << std::endl;
+        return false;
+    }
+
+    // Adds new facts with their delta logged. Constants not seen before are
+    // interned as they come; printing falls back to string order then.
+    size_t insertFacts(const DatalogProgram& update) {
+        auto facts = collectFacts(update);
+        std::set<std::string> tracked(derivedRelations);
+        for (const auto& fact : facts) tracked.insert(fact.first);
+        db.trackDeltas(tracked);
+
+        size_t added = 0;
+        SymbolTable& symbols = db.getSymbols();
+        for (const auto& fact : facts) {
+            if (!knownRelation(fact.first, fact.second.size())) continue;
+            Tuple tuple;
+            for (std::string_view value : fact.second) tuple.push_back(symbols.intern(std::string(stripQuotes(value))));
+            if (addFact(fact.first, tuple)) added++;
+        }
+        return added;
+    }
+
+    // Delete and rederive. Everything with a derivation through a removed
+    // tuple is deleted first (over-deletion, evaluated against the old
+    // state); then tuples that still have a derivation from what is left,
+    // or that were given as facts, are put back and logged as deltas for
+    // propagate() to finish. Returns the number of facts removed.
+    size_t retractFacts(const DatalogProgram& update) {
+        std::map<std::string, Relation> deleted;
+        auto deletedOf = [&](const std::string& name) -> Relation& {
+            auto it = deleted.find(name);
+            if (it == deleted.end()) {
+                it = deleted.emplace(name, Relation(name, db.getRelation(name).getScheme())).first;
+            }
+            return it->second;
+        };
+
+        size_t removed = 0;
+        const SymbolTable& symbols = db.getSymbols();
+        for (const auto& fact : collectFacts(update)) {
+            if (!knownRelation(fact.first, fact.second.size())) continue;
+            Tuple tuple;
+            bool known = true;
+            for (std::string_view value : fact.second) {
+                Symbol id;
+                known = known && symbols.lookup(std::string(stripQuotes(value)), id);
+                tuple.push_back(known ? id : 0);
+            }
+            if (!known || !db.getRelation(fact.first).getTuples().contains(tuple)) continue;
+            auto given = derivedFacts.find(fact.first);
+            if (given != derivedFacts.end()) given->second.erase(tuple);
+            if (deletedOf(fact.first).addTuple(tuple)) removed++;
+        }
+        if (removed == 0) return 0;
+
+        // Rule results come from the arena; the deleted sets above and the
+        // frontiers below are kept on the heap
+        Arena arena;
+
+        // Over-delete, SCC by SCC, until no rule finds another deleted tuple
+        for (const auto& scc : sccOrder) {
+            std::map<std::string, Relation> frontier = deleted;
+            while (!frontier.empty()) {
+                std::map<std::string, Relation> next;
+                for (int ruleIndex : scc) {
+                    const Rule& rule = program.getRules()[ruleIndex];
+                    const std::string& head = rule.getHeadPredicate().getName();
+                    std::vector<const Relation*> deltas;
+                    for (const auto& bodyPred : rule.getBodyPredicates()) {
+                        auto it = frontier.find(bodyPred.getName());
+                        deltas.push_back(it == frontier.end() ? nullptr : &it->second);
+                    }
+                    Relation& target = deletedOf(head);
+                    {
+                        ArenaScope scope(arena);
+                        Relation derived = projectHead(rule, evaluateDeltaProbe(rule, deltas));
+                        for (const Tuple& t : derived.getTuples()) {
+                            if (db.getRelation(head).getTuples().contains(t) && target.addTuple(t)) {
+                                auto it = next.find(head);
+                                if (it == next.end()) it = next.emplace(head, Relation(head, target.getScheme())).first;
+                                it->second.addTuple(t);
+                            }
+                        }
+                    }
+                    arena.reset();
+                }
+                frontier = std::move(next);
+            }
+        }
+
+        for (const auto& pair : deleted) {
+            for (const Tuple& t : pair.second.getTuples()) db.eraseTuple(pair.first, t);
+        }
+
+        // Rederive from the remaining tuples, starting from the head bindings
+        db.trackDeltas(derivedRelations);
+        for (const auto& pair : deleted) {
+            auto given = derivedFacts.find(pair.first);
+            if (given == derivedFacts.end()) continue;
+            for (const Tuple& t : pair.second.getTuples()) {
+                if (given->second.contains(t)) db.addTuple(pair.first, t);
+            }
+        }
+        for (const Rule& rule : program.getRules()) {
+            const Predicate& head = rule.getHeadPredicate();
+            auto it = deleted.find(head.getName());
+            if (it == deleted.end()) continue;
+            const auto& body = rule.getBodyPredicates();
+            {
+                ArenaScope scope(arena);
+                Relation bindings = evaluatePredicate(head, it->second);
+                addRuleResult(rule, extendBindings(body, std::move(bindings), std::vector<bool>(body.size(), false)), nullptr);
+            }
+            arena.reset();
+        }
+        return removed;
+    }
+
+    // Semi-naive over every SCC in order, seeded with the logged deltas
+    // instead of a naive first pass; rule output is not printed
+    void propagate() {
+        Arena arena;
+        for (const auto& scc : sccOrder) {
+            std::vector<std::vector<size_t>> marks;
+            for (int ruleIndex : scc) {
+                marks.emplace_back(program.getRules()[ruleIndex].getBodyPredicates().size(), 0);
+            }
+            bool changed;
+            do {
+                changed = false;
+                for (size_t k = 0; k < scc.size(); ++k) {
+                    const Rule& rule = program.getRules()[scc[k]];
+                    const auto& body = rule.getBodyPredicates();
+                    {
+                        ArenaScope scope(arena);
+                        std::vector<size_t> newMarks;
+                        std::vector<Relation> deltas;
+                        for (size_t i = 0; i < body.size(); ++i) {
+                            newMarks.push_back(db.deltaMark(body[i].getName()));
+                            deltas.push_back(db.getDelta(body[i].getName(), marks[k][i]));
+                        }
+                        std::vector<const Relation*> views;
+                        for (const Relation& delta : deltas) views.push_back(&delta);
+                        Relation result = evaluateDeltaProbe(rule, views);
+                        marks[k] = newMarks;
+                        if (addRuleResult(rule, std::move(result), nullptr)) changed = true;
+                    }
+                    arena.reset();
+                }
+            } while (changed);
+        }
+        db.clearDeltas();
+    }
+
+    // Stored tuples of `pred` that agree with some binding on the variables
+    // they share, looked up through column indexes one distinct key at a time
+    Relation probe(const Predicate& pred, const Relation& bindings) {
+        const Relation& source = db.getRelation(pred.getName());
+        ScanPlan plan = planScan(pred);
+        Scheme scheme(plan.renameAttrs);
+        if (!plan.satisfiable) return Relation(pred.getName(), scheme);
+
+        std::vector<std::pair<size_t, size_t>> keys; // (source column, bindings column)
+        const Scheme& bound = bindings.getScheme();
+        for (size_t k = 0; k < plan.renameAttrs.size(); ++k) {
+            auto it = std::find(bound.begin(), bound.end(), plan.renameAttrs[k]);
+            if (it != bound.end()) keys.emplace_back(plan.projectIndices[k], it - bound.begin());
+        }
+        if (keys.empty()) return evaluatePredicate(pred, source);
+
+        Relation result(pred.getName(), scheme, Arena::current());
+        std::set<std::vector<Symbol>> seen;
+        for (const Tuple& t : bindings.getTuples()) {
+            std::vector<Symbol> key;
+            for (const auto& k : keys) key.push_back(t[k.second]);
+            if (!seen.insert(key).second) continue;
+
+            std::vector<std::pair<size_t, Symbol>> constants;
+            for (size_t c = 0; c < keys.size(); ++c) constants.emplace_back(keys[c].first, key[c]);
+            constants.insert(constants.end(), plan.constants.begin(), plan.constants.end());
+            result.Union(source.scan(constants, plan.equalities, plan.projectIndices, scheme));
+        }
+        return result;
+    }
+
+    // Join the unused body predicates onto the bindings, each probed with
+    // the values bound so far; connected predicates go first
+    Relation extendBindings(const std::vector<Predicate>& body, Relation bindings, std::vector<bool> used) {
+        for (size_t step = 0; step < body.size() && !bindings.getTuples().empty(); ++step) {
+            size_t next = body.size();
+            for (size_t j = 0; j < body.size(); ++j) {
+                if (used[j]) continue;
+                if (next == body.size()) next = j;
+                if (sharesAttribute(Scheme(planScan(body[j]).renameAttrs), bindings.getScheme())) {
+                    next = j;
+                    break;
+                }
+            }
+            if (next == body.size()) break;
+            used[next] = true;
+            bindings = bindings.join(probe(body[next], bindings), joinMethod, pool.get());
+        }
+        return bindings;
+    }
+
+    // Delta rule evaluation whose cost follows the deltas (one per body
+    // position, null for none): each nonempty delta starts from its tuples
+    // and probes the other predicates
+    Relation evaluateDeltaProbe(const Rule& rule, const std::vector<const Relation*>& deltas) {
+        const auto& body = rule.getBodyPredicates();
+        Scheme canonical;
+        for (const auto& bodyPred : body) {
+            for (const auto& attr : planScan(bodyPred).renameAttrs) {
+                if (std::find(canonical.begin(), canonical.end(), attr) == canonical.end()) canonical.push_back(attr);
+            }
+        }
+
+        Relation result(rule.getHeadPredicate().getName(), canonical, Arena::current());
+        for (size_t i = 0; i < body.size(); ++i) {
+            if (!deltas[i] || deltas[i]->getTuples().empty()) continue;
+
+            std::vector<bool> used(body.size(), false);
+            used[i] = true;
+            Relation bindings = extendBindings(body, evaluatePredicate(body[i], *deltas[i]), used);
+            if (bindings.getTuples().empty()) continue;
+
+            std::vector<size_t> columns;
+            const Scheme& scheme = bindings.getScheme();
+            for (const auto& attr : canonical) {
+                columns.push_back(std::find(scheme.begin(), scheme.end(), attr) - scheme.begin());
+            }
+            result.Union(std::move(bindings).scan({}, {}, columns, canonical));
+        }
+        return result;
+    }
+
+    // The joined body projected and renamed to the head relation's scheme
+    Relation projectHead(const Rule& rule, Relation result) {
+        const auto& headPredicate = rule.getHeadPredicate();
+        std::vector<size_t> headProjectIndices;
+        std::vector<std::string> outputVarNames;
+
+        for (const auto& headParam : headPredicate.getParameters()) {
+            outputVarNames.push_back(headParam.getValue());
+        }
+
+        // Find position of head variables in the results scheme
+        for (const auto& varName : outputVarNames) {
+            for (size_t i = 0; i < result.getScheme().size(); ++i) {
+                if (result.getScheme()[i] == varName) {
+                    headProjectIndices.push_back(i);
+                    break;
+                }
+            }
+        }
+
+        // Project and rename to match the TARGET relation's scheme
+        const Relation& target = db.getRelation(headPredicate.getName());
+        return profiler.measure(Profiler::SCAN, [&] {
+            return std::move(result).scan({}, {}, headProjectIndices, target.getScheme());
+        });
+    }
+
+    // Project the joined body onto the head, add it to the target relation
+    // and print the new tuples to `out`, if given. Returns true if anything
+    // was added.
+    bool addRuleResult(const Rule& rule, Relation result, std::ostream* out) {
+        if (result.getTuples().empty()) {
+            profiler.endRule(0);
+            return false;
+        }
+
+        const auto& headPredicate = rule.getHeadPredicate();
+        const Relation& target = db.getRelation(headPredicate.getName());
+        result = projectHead(rule, std::move(result));
+
+        // Collect new tuples and print using TARGET's scheme
+        std::vector<Tuple> newTuples;
+        for (const auto& t : result.getTuples()) {
+            if (db.addTuple(headPredicate.getName(), t)) {
+                newTuples.push_back(t);
+            }
+        }
+        profiler.endRule(newTuples.size());
+        if (!out) return !newTuples.empty();
+
+        // Relations are unordered; print new tuples sorted by their strings
+        const SymbolTable& symbols = db.getSymbols();
+        std::sort(newTuples.begin(), newTuples.end(),
+                  [&](const Tuple& a, const Tuple& b) { return symbols.less(a, b); });
+
+        // Print tuples with TARGET's attribute names
+        const Scheme& targetScheme = target.getScheme();
+        for (const auto& t : newTuples) {
+            *out << "  ";
+            for (size_t i = 0; i < targetScheme.size(); ++i) {
+                *out << targetScheme[i] << "='" << symbols.name(t[i]) << "'";
+                if (i < targetScheme.size() - 1) *out << ", ";
+            }
+            *out << std::endl;
+        }
+
+        return !newTuples.empty();
+    }
+
+    // Join a rule body: in full on the first pass (or in naive mode),
+    // otherwise only against what was added since `marks`
+    Relation evaluateBody(const Rule& rule, const std::vector<size_t>& marks) {
+        if (semiNaive && !marks.empty()) return evaluateDeltaBody(rule, marks);
+        const auto& body = rule.getBodyPredicates();
+        if (body.size() == 1) return evaluatePredicate(body[0]);
+        std::vector<Relation> scanned;
+        scanned.reserve(body.size());
+        std::vector<RelationView> inputs;
+        for (const auto& bodyPred : body) inputs.push_back(bodyInput(bodyPred, scanned));
+        return joinAll(inputs);
+    }
+
+    int evaluateRules(const std::vector<int>& ruleIndices = std::vector<int>(), bool printRules = true,
+                      std::ostream& out = std::cout, int sccNumber = 0) {
         int passes = 0;
         bool changed;
         
@@ -340,105 +981,88 @@ private:
             indicesToUse = ruleIndices; // Use the specified indices
         }
 
-        do {
-            changed = false;
-
+        // Semi-naive: log new tuples of this SCC's head relations so each rule
+        // only has to join against what was added since it last ran
+        std::vector<std::vector<size_t>> marks(indicesToUse.size());
+        std::set<std::string> heads;
+        if (semiNaive) {
             for (int ruleIndex : indicesToUse) {
-                const Rule& rule = program.getRules()[ruleIndex];
-                if (printRules) {
-                    std::cout << rule.toString() << "." << std::endl;
-                }
+                heads.insert(program.getRules()[ruleIndex].getHeadPredicate().getName());
+            }
+            db.trackDeltas(heads);
+        }
 
-                std::vector<Relation> intermediates;
+        // Parallel rules: each pass evaluates every body against the state at
+        // the start of the pass, then adds the results in rule order
+        bool parallel = parallelRules && pool && indicesToUse.size() > 1 && !profiler.isEnabled();
 
-                // Process body predicates
-                for (const auto& bodyPred : rule.getBodyPredicates()) {
-                    Relation r = db.getRelation(bodyPred.getName());
-                    auto params = bodyPred.getParameters();
+        // Intermediate relations of one rule evaluation live in an arena
+        // that is rewound once its result has been added. In parallel, each
+        // rule has its own, kept until the merge at the end of the pass.
+        std::vector<Arena> arenas(parallel ? indicesToUse.size() : 1);
 
-                    std::map<std::string, int> varIndices;
-                    std::vector<size_t> projectIndices;
-                    std::vector<std::string> renameAttrs;
+        do {
+            changed = false;
 
-                    for (size_t i = 0; i < params.size(); ++i) {
-                        const auto& param = params[i];
-                        if (!param.getIsID()) {
-                            std::string value = param.getValue();
-                            if (value.size() >= 2 && value.front() == '\'' && value.back() == '\'') {
-                                value = value.substr(1, value.size() - 2);
-                            }
-                            r = r.select(i, value);
-                        } else {
-                            const std::string& varName = param.getValue();
-                            if (varIndices.find(varName) != varIndices.end()) {
-                                r = r.select(varIndices[varName], i);
-                            } else {
-                                varIndices[varName] = i;
-                                projectIndices.push_back(i);
-                                renameAttrs.push_back(varName);
-                            }
-                        }
+            if (parallel) {
+                for (Arena& arena : arenas) arena.reset();
+                TaskGroup group(*pool);
+                std::vector<std::vector<size_t>> newMarks(indicesToUse.size());
+                std::vector<Relation> results;
+                results.reserve(indicesToUse.size());
+                for (Arena& arena : arenas) results.emplace_back("", Scheme(), &arena);
+                for (size_t k = 0; k < indicesToUse.size(); ++k) {
+                    const Rule& rule = program.getRules()[indicesToUse[k]];
+                    for (const auto& bodyPred : rule.getBodyPredicates()) {
+                        newMarks[k].push_back(db.deltaMark(bodyPred.getName()));
                     }
-
-                    r = r.project(projectIndices);
-                    r = r.rename(renameAttrs);
-                    intermediates.push_back(r);
+                    if (rule.getBodyPredicates().empty()) continue;
+                    group.run([this, &rule, &results, &marks, &arenas, k] {
+                        ArenaScope scope(arenas[k]);
+                        results[k] = evaluateBody(rule, marks[k]);
+                    });
                 }
+                group.wait();
 
-                if (intermediates.empty()) continue;
-                
-                Relation result = intermediates[0];
-                for (size_t i = 1; i < intermediates.size(); ++i) {
-                    result = result.join(intermediates[i]);
-                }
-
-                // Process head-predicate
-                const auto& headPredicate = rule.getHeadPredicate();
-                std::vector<size_t> headProjectIndices;
-                std::vector<std::string> outputVarNames;
-
-                for (const auto& headParam : headPredicate.getParameters()) {
-                    outputVarNames.push_back(headParam.getValue());
-                }
-
-                // Find position of head variables in the results scheme
-                for (const auto& varName : outputVarNames) {
-                    for (size_t i = 0; i < result.getScheme().size(); ++i) {
-                        if (result.getScheme()[i] == varName) {
-                            headProjectIndices.push_back(i);
-                            break;
-                        }
+                for (size_t k = 0; k < indicesToUse.size(); ++k) {
+                    const Rule& rule = program.getRules()[indicesToUse[k]];
+                    if (printRules) {
+                        out << rule.toString() << "." << std::endl;
+                    }
+                    if (rule.getBodyPredicates().empty()) continue;
+                    marks[k] = newMarks[k];
+                    ArenaScope scope(arenas[k]);
+                    if (addRuleResult(rule, std::move(results[k]), &out)) {
+                        changed = true;
                     }
                 }
+            }
 
-                result = result.project(headProjectIndices);
+            for (size_t k = 0; !parallel && k < indicesToUse.size(); ++k) {
+                const Rule& rule = program.getRules()[indicesToUse[k]];
+                if (printRules) {
+                    out << rule.toString() << "." << std::endl;
+                }
 
-                // Rename to match the TARGET relation's scheme
-                Relation& target = db.getRelation(headPredicate.getName());
-                result = result.rename(target.getScheme());
+                const auto& body = rule.getBodyPredicates();
+                if (body.empty()) continue;
 
-                // Collect new tuples and print using TARGET's scheme
-                std::vector<Tuple> newTuples;
-                for (const auto& t : result.getTuples()) {
-                    if (target.addTuple(t)) {
-                        newTuples.push_back(t);
-                    }
+                profiler.beginRule(sccNumber, indicesToUse[k], passes + 1);
+                std::vector<size_t> newMarks;
+                for (const auto& bodyPred : body) {
+                    newMarks.push_back(db.deltaMark(bodyPred.getName()));
                 }
 
-                // Print tuples with TARGET's attribute names
-                const Scheme& targetScheme = target.getScheme();
-                for (const auto& t : newTuples) {
-                    std::cout << "  ";
-                    for (size_t i = 0; i < targetScheme.size(); ++i) {
-                        std::cout << targetScheme[i] << "='" << t[i] << "'";
-                        if (i < targetScheme.size() - 1) std::cout << ", ";
-                    }
-                    std::cout << std::endl;
-                }
+                {
+                    ArenaScope scope(arenas[0]);
+                    Relation result = evaluateBody(rule, marks[k]);
+                    marks[k] = newMarks;
 
-                if (!newTuples.empty()) {
-                    changed = true;
+                    if (addRuleResult(rule, std::move(result), &out)) {
+                        changed = true;
+                    }
                 }
+                arenas[0].reset();
             }
 
             if (changed) {
@@ -447,6 +1071,7 @@ private:
 
         } while (changed);
 
+        if (semiNaive) db.clearDeltas(heads);
         return passes;
     }
 };
\ No newline at end of file
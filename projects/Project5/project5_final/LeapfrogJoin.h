@@ -0,0 +1,254 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+#include "Relation.h"
+#include "Scheme.h"
+#include "Tuple.h"
+
+using namespace std;
+
+// Worst-case optimal multi-way join (leapfrog triejoin). Every input is
+// sorted into a trie whose levels follow one global variable order; the
+// join then binds one variable at a time by intersecting the matching
+// trie levels of the inputs that contain it. Unlike a chain of pairwise
+// joins, no intermediate result can be larger than the final output
+// bound, which is what matters for cyclic bodies like triangles.
+class LeapfrogJoin
+{
+private:
+    // Largest input over smallest above which pairwise joins win
+    static const size_t MAX_SKEW = 16;
+
+    // A sorted relation walked as a trie, one level per column
+    class TrieIterator
+    {
+    private:
+        vector<vector<Symbol>> rows; // columns in global variable order, sorted
+        vector<size_t> begins;       // per open level: start of its range
+        vector<size_t> ends;         // per open level: end of its range
+        vector<size_t> positions;    // per open level: current row
+
+        size_t level() const { return positions.size() - 1; }
+
+    public:
+        vector<size_t> variables; // global variable index of each column, ascending
+
+        TrieIterator(const Relation& relation, const vector<size_t>& columnOrder, vector<size_t> vars)
+            : variables(std::move(vars))
+        {
+            rows.reserve(relation.size());
+            for (const Tuple& tuple : relation.getTuples())
+            {
+                vector<Symbol> row;
+                row.reserve(columnOrder.size());
+                for (size_t column : columnOrder) row.push_back(tuple[column]);
+                rows.push_back(std::move(row));
+            }
+            sort(rows.begin(), rows.end());
+        }
+
+        // Descend to the children of the current key (or the root level)
+        void open()
+        {
+            size_t begin = 0, end = rows.size();
+            if (!positions.empty())
+            {
+                begin = positions.back();
+                end = upperBound(begin, ends.back(), rows[begin][level()]);
+            }
+            begins.push_back(begin);
+            ends.push_back(end);
+            positions.push_back(begin);
+        }
+
+        void up()
+        {
+            begins.pop_back();
+            ends.pop_back();
+            positions.pop_back();
+        }
+
+        bool atEnd() const { return positions.back() >= ends.back(); }
+        Symbol key() const { return rows[positions.back()][level()]; }
+
+        // First row in [from, to) whose key at this level is > value
+        size_t upperBound(size_t from, size_t to, Symbol value) const
+        {
+            size_t d = positions.size() - 1;
+            auto it = std::upper_bound(rows.begin() + from, rows.begin() + to, value,
+                                       [d](Symbol v, const vector<Symbol>& row) { return v < row[d]; });
+            return it - rows.begin();
+        }
+
+        void next()
+        {
+            positions.back() = upperBound(positions.back(), ends.back(), key());
+        }
+
+        // Move to the first key >= value
+        void seek(Symbol value)
+        {
+            size_t d = level();
+            auto it = std::lower_bound(rows.begin() + positions.back(), rows.begin() + ends.back(), value,
+                                       [d](const vector<Symbol>& row, Symbol v) { return row[d] < v; });
+            positions.back() = it - rows.begin();
+        }
+    };
+
+    vector<TrieIterator> tries;
+    vector<vector<TrieIterator*>> byVariable; // tries containing each variable
+    vector<Symbol> binding;
+    Relation* result = nullptr;
+
+    void search(size_t var)
+    {
+        if (var == binding.size())
+        {
+            Tuple tuple(result->getTuples().resource());
+            tuple.assign(binding.begin(), binding.end());
+            result->addTuple(std::move(tuple));
+            return;
+        }
+
+        vector<TrieIterator*>& its = byVariable[var];
+        for (TrieIterator* it : its) it->open();
+        bool empty = false;
+        for (TrieIterator* it : its) empty = empty || it->atEnd();
+
+        if (!empty)
+        {
+            sort(its.begin(), its.end(), [](TrieIterator* a, TrieIterator* b) { return a->key() < b->key(); });
+            size_t k = its.size();
+            size_t p = 0;
+            while (true)
+            {
+                Symbol max = its[(p + k - 1) % k]->key();
+                Symbol x = its[p]->key();
+                if (x == max)
+                {
+                    binding[var] = x;
+                    search(var + 1);
+                    its[p]->next();
+                }
+                else
+                {
+                    its[p]->seek(max);
+                }
+                if (its[p]->atEnd()) break;
+                p = (p + 1) % k;
+            }
+        }
+
+        for (TrieIterator* it : its) it->up();
+    }
+
+public:
+    // GYO reduction: repeatedly drop variables that occur in only one input
+    // and inputs whose variables are covered by another input. The body is
+    // acyclic iff this leaves at most one input.
+    static bool isCyclic(const vector<Scheme>& schemes)
+    {
+        vector<set<string>> edges;
+        for (const Scheme& scheme : schemes)
+        {
+            if (!scheme.empty()) edges.emplace_back(scheme.begin(), scheme.end());
+        }
+
+        bool changed = true;
+        while (changed && edges.size() > 1)
+        {
+            changed = false;
+            for (auto& edge : edges)
+            {
+                for (auto it = edge.begin(); it != edge.end();)
+                {
+                    size_t count = 0;
+                    for (const auto& other : edges) count += other.count(*it);
+                    if (count == 1)
+                    {
+                        it = edge.erase(it);
+                        changed = true;
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+            }
+            for (size_t i = 0; i < edges.size(); i++)
+            {
+                for (size_t j = 0; j < edges.size(); j++)
+                {
+                    if (i == j) continue;
+                    if (includes(edges[j].begin(), edges[j].end(), edges[i].begin(), edges[i].end()))
+                    {
+                        edges.erase(edges.begin() + i);
+                        changed = true;
+                        i--;
+                        break;
+                    }
+                }
+            }
+        }
+        return edges.size() > 1;
+    }
+
+    // Every input is sorted in full, so when one is far smaller than the
+    // rest (a semi-naive delta, typically) pairwise joins that start from
+    // it and probe the others' indexes do less work
+    static bool pays(const vector<RelationView>& inputs)
+    {
+        size_t smallest = SIZE_MAX, largest = 0;
+        for (const RelationView& view : inputs)
+        {
+            smallest = min(smallest, view.relation->size());
+            largest = max(largest, view.relation->size());
+        }
+        return largest <= smallest * MAX_SKEW;
+    }
+
+    // Join the inputs; the result's scheme is `variables`, which must list
+    // every attribute of every input
+    static Relation join(const vector<RelationView>& inputs, const Scheme& variables)
+    {
+        Relation output(inputs.empty() ? "" : inputs[0].relation->getName(), variables, Arena::current());
+        LeapfrogJoin lftj;
+        lftj.result = &output;
+        lftj.binding.resize(variables.size());
+        lftj.byVariable.resize(variables.size());
+        lftj.tries.reserve(inputs.size());
+
+        for (const RelationView& view : inputs)
+        {
+            const Relation& input = *view.relation;
+            if (input.getTuples().empty()) return output;
+            const Scheme& scheme = view.scheme;
+            if (scheme.empty()) continue; // a satisfied ground predicate
+
+            // Columns of this input ordered by their global variable index
+            vector<pair<size_t, size_t>> order;
+            for (size_t c = 0; c < scheme.size(); c++)
+            {
+                order.emplace_back(find(variables.begin(), variables.end(), scheme[c]) - variables.begin(), c);
+            }
+            sort(order.begin(), order.end());
+            vector<size_t> columns, vars;
+            for (const auto& pair : order)
+            {
+                vars.push_back(pair.first);
+                columns.push_back(pair.second);
+            }
+            lftj.tries.emplace_back(input, columns, vars);
+        }
+
+        for (TrieIterator& trie : lftj.tries)
+        {
+            for (size_t var : trie.variables) lftj.byVariable[var].push_back(&trie);
+        }
+        lftj.search(0);
+        return output;
+    }
+};
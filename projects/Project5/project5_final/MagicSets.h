@@ -0,0 +1,202 @@
+#pragma once
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "DatalogProgram.h"
+
+using namespace std;
+
+// Magic-sets rewrite. Each derived predicate reachable from a query is
+// specialized per adornment (which arguments arrive bound, 'b', or free,
+// 'f'), and a magic relation holding the bound values that are actually
+// demanded guards its rules. Bindings flow through rule bodies in an
+// order that follows shared variables. A query like path('a',X)? then
+// derives only what is reachable from 'a' instead of the whole closure.
+class MagicSets
+{
+private:
+    const DatalogProgram& source;
+    DatalogProgram result;
+    set<string> derived;
+    map<string, Predicate> schemes;
+    set<string> done; // adorned names already specialized
+    deque<pair<string, string>> pending;
+
+    // Generated names contain '$', which identifiers cannot, so they never
+    // clash with a relation of the program
+    static string adornedName(const string& name, const string& adornment)
+    {
+        return name + "$" + adornment;
+    }
+
+    static string magicName(const string& name, const string& adornment)
+    {
+        return "magic$" + name + "$" + adornment;
+    }
+
+    // Parameters at the bound positions of an adornment
+    static Predicate boundPart(const string& name, const vector<Parameter>& params, const string& adornment)
+    {
+        Predicate pred(name);
+        for (size_t i = 0; i < params.size(); i++)
+        {
+            if (adornment[i] == 'b') pred.addParameter(params[i]);
+        }
+        return pred;
+    }
+
+    // Schemes for p$a and magic$p$a, plus the work item, on first demand
+    void demand(const string& name, const string& adornment)
+    {
+        string adorned = adornedName(name, adornment);
+        if (!done.insert(adorned).second) return;
+
+        const Predicate& scheme = schemes.at(name);
+        Predicate copy = scheme;
+        copy.setName(adorned);
+        result.addScheme(copy);
+        if (adornment.find('b') != string::npos)
+        {
+            result.addScheme(boundPart(magicName(name, adornment), scheme.getParameters(), adornment));
+        }
+        pending.emplace_back(name, adornment);
+
+        // A derived predicate's own facts, including any added by later
+        // updates, reach the adorned copy through one extra guarded rule
+        Rule copyFacts(copy);
+        if (adornment.find('b') != string::npos)
+        {
+            copyFacts.addBodyPredicate(boundPart(magicName(name, adornment), scheme.getParameters(), adornment));
+        }
+        copyFacts.addBodyPredicate(scheme);
+        result.addRule(std::move(copyFacts));
+    }
+
+    // Sideways information passing order: repeatedly take the literal with
+    // the most arguments already bound (constants count), ties in written
+    // order. Passing bindings along shared variables keeps the magic rules
+    // from becoming cross products.
+    static vector<Predicate> sipsOrder(const vector<Predicate>& body, set<string> bound)
+    {
+        vector<Predicate> order;
+        vector<bool> used(body.size(), false);
+        for (size_t step = 0; step < body.size(); step++)
+        {
+            size_t best = body.size();
+            size_t bestBound = 0;
+            for (size_t i = 0; i < body.size(); i++)
+            {
+                if (used[i]) continue;
+                size_t count = 0;
+                for (const Parameter& param : body[i].getParameters())
+                {
+                    if (!param.getIsID() || bound.count(param.getValue())) count++;
+                }
+                if (best == body.size() || count > bestBound)
+                {
+                    best = i;
+                    bestBound = count;
+                }
+            }
+            used[best] = true;
+            order.push_back(body[best]);
+            for (const Parameter& param : body[best].getParameters())
+            {
+                if (param.getIsID()) bound.insert(param.getValue());
+            }
+        }
+        return order;
+    }
+
+    void specialize(const Rule& rule, const string& adornment)
+    {
+        const Predicate& head = rule.getHeadPredicate();
+        bool guarded = adornment.find('b') != string::npos;
+        Predicate magicHead = boundPart(magicName(head.getName(), adornment), head.getParameters(), adornment);
+
+        set<string> bound;
+        for (size_t i = 0; i < adornment.size(); i++)
+        {
+            if (adornment[i] == 'b') bound.insert(head.getParameters()[i].getValue());
+        }
+
+        Predicate newHead = head;
+        newHead.setName(adornedName(head.getName(), adornment));
+        Rule adorned(newHead);
+        if (guarded) adorned.addBodyPredicate(magicHead);
+
+        for (const Predicate& pred : sipsOrder(rule.getBodyPredicates(), bound))
+        {
+            Predicate literal = pred;
+            if (derived.count(pred.getName()))
+            {
+                // Constants in a rule body still filter at the literal, so
+                // only variables bound so far are passed down
+                string inner;
+                for (const Parameter& param : pred.getParameters())
+                {
+                    inner += param.getIsID() && bound.count(param.getValue()) ? 'b' : 'f';
+                }
+                demand(pred.getName(), inner);
+                literal.setName(adornedName(pred.getName(), inner));
+
+                if (inner.find('b') != string::npos)
+                {
+                    Rule magic(boundPart(magicName(pred.getName(), inner), pred.getParameters(), inner));
+                    for (const Predicate& before : adorned.getBodyPredicates()) magic.addBodyPredicate(before);
+                    if (!magic.getBodyPredicates().empty()) result.addRule(std::move(magic));
+                }
+            }
+            for (const Parameter& param : pred.getParameters())
+            {
+                if (param.getIsID()) bound.insert(param.getValue());
+            }
+            adorned.addBodyPredicate(std::move(literal));
+        }
+        result.addRule(std::move(adorned));
+    }
+
+public:
+    explicit MagicSets(const DatalogProgram& program) : source(program), result(program)
+    {
+        result.clearRules();
+        for (const Predicate& scheme : program.getSchemes()) schemes[scheme.getName()] = scheme;
+        for (const Rule& rule : program.getRules()) derived.insert(rule.getHeadPredicate().getName());
+    }
+
+    // The rewritten program. queryRelations[i] names the relation that
+    // answers query i; queries on base relations read them unchanged.
+    DatalogProgram rewrite(vector<string>& queryRelations)
+    {
+        queryRelations.clear();
+        for (const Predicate& query : source.getQueries())
+        {
+            if (!derived.count(query.getName()))
+            {
+                queryRelations.push_back(query.getName());
+                continue;
+            }
+            string adornment;
+            for (const Parameter& param : query.getParameters()) adornment += param.getIsID() ? 'f' : 'b';
+            demand(query.getName(), adornment);
+            queryRelations.push_back(adornedName(query.getName(), adornment));
+            if (adornment.find('b') != string::npos)
+            {
+                result.addFact(boundPart(magicName(query.getName(), adornment), query.getParameters(), adornment));
+            }
+        }
+
+        while (!pending.empty())
+        {
+            pair<string, string> item = pending.front();
+            pending.pop_front();
+            for (const Rule& rule : source.getRules())
+            {
+                if (rule.getHeadPredicate().getName() == item.first) specialize(rule, item.second);
+            }
+        }
+        return std::move(result);
+    }
+};
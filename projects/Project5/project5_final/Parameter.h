@@ -20,7 +20,7 @@ public:
             this->isID = (value[0] != '\'');
         }
     }
-string getValue() const
+const string& getValue() const
 {
     return this->value;
 } 
@@ -11,7 +11,9 @@
 class Parser
 {
  private:
-    vector<Token> tokens;
+    Scanner& scanner;
+    Token current; // one token of lookahead, pulled from the scanner on demand
+    vector<string_view> factValues; // scratch buffer reused by fact()
     void parseScheme();
     void parseFact();
     void parseRule();
@@ -19,22 +21,27 @@ class Parser
 	DatalogProgram datalog;
 
  public:
-    Parser(const std::vector<Token>& tokens) : tokens(tokens) {} 
+    Parser(Scanner& scanner) : scanner(scanner), current(scanner.scanTokens()) {} 
+
+    const Token& currentToken() const
+    {
+        return current;
+    }
 
     TokenType tokenType() const
     {
-        return tokens.at(0).getType();
+        return currentToken().getType();
     }
 
     void advanceToken()
     {
-        tokens.erase(tokens.begin());
+        if (current.getType() != TokenType::END) current = scanner.scanTokens();
     }
 
     void throwError()
     {
        //std::cout << "error" << std::endl;
-	   throw tokens.at(0);
+	   throw currentToken();
     }
 
     void match(TokenType t) {        
@@ -46,83 +53,83 @@ class Parser
     }
      
 void idList(Predicate &pred) {
-    if (tokenType() == TokenType::COMMA) {
+    while (tokenType() == TokenType::COMMA) {
         match(TokenType::COMMA); // Skips comments before comma
-        pred.addParameter(Parameter(tokens.at(0).getValue()));
+        pred.addParameter(Parameter(string(currentToken().getValue())));
         match(TokenType::ID); // Skips comments after comma
-        idList(pred);
     }
 }
 
     void scheme()
 	{
 	  Predicate pred = Predicate();
-	  pred.setName(this->tokens.at(0).getValue());
+	  pred.setName(string(currentToken().getValue()));
 	  match(TokenType::ID);
 	  match(TokenType::LEFT_PAREN);
 
-	  pred.addParameter(Parameter(this->tokens.at(0).getValue()));
+	  pred.addParameter(Parameter(string(currentToken().getValue())));
 
 	  match(TokenType::ID);
 	  idList(pred);
 	  match(TokenType::RIGHT_PAREN);
-	  this->datalog.addScheme(pred);
+	  this->datalog.addScheme(std::move(pred));
 	  //pred.clear();
 	}
 
 	void schemeList()
 	{
-		if (tokenType() == TokenType::ID)
+		while (tokenType() == TokenType::ID)
 		{
 			scheme();
-			schemeList();
 		}
 
 	}
 
 	void factList()
 	{
-		if (tokenType() == TokenType::ID)
+		while (tokenType() == TokenType::ID)
 		{
 			fact();
-			factList();
 		}
 	}
 
 	void ruleList()
 	{
-		if (tokenType() == TokenType::ID)
+		while (tokenType() == TokenType::ID)
 		{
 			rule();
-			ruleList();
 		}
 
 	}
 
 	void queryList()
 	{
-		if (tokenType() == TokenType::ID)
+		while (tokenType() == TokenType::ID)
 		{
 			query();
-			queryList();
 		}
 	}
 
+	// Facts skip the Predicate/Parameter AST and go straight into a flat batch
 	void fact()
 	{
-	  Predicate pred = Predicate();
-	  pred.setName(this->tokens.at(0).getValue());
+	  string_view name = currentToken().getValue();
 	  match(TokenType::ID);
 	  match(TokenType::LEFT_PAREN);
 
-	  pred.addParameter(Parameter(this->tokens.at(0).getValue()));
+	  factValues.clear();
+	  factValues.push_back(currentToken().getValue());
 	  match(TokenType::STRING);
-	  stringList(pred);
+	  while (tokenType() == TokenType::COMMA)
+	  {
+	    match(TokenType::COMMA);
+	    factValues.push_back(currentToken().getValue());
+	    match(TokenType::STRING);
+	  }
 
 	  match(TokenType::RIGHT_PAREN);
 	  match(TokenType::PERIOD);
-	  this->datalog.addFact(pred);
-	  //pred.clear();
+	  this->datalog.addFactValues(name, factValues);
 	}
 
 	void rule()
@@ -140,7 +147,7 @@ void idList(Predicate &pred) {
 			throwError();
 		}
 
-		datalog.addRule(rule);
+		datalog.addRule(std::move(rule));
 
 	}
 	
@@ -148,7 +155,7 @@ void idList(Predicate &pred) {
 	{
 		Predicate pred = predicate();
 		match(TokenType::Q_MARK);
-		datalog.addQuery(pred);
+		datalog.addQuery(std::move(pred));
 	}
 
 
@@ -156,13 +163,13 @@ void idList(Predicate &pred) {
 	{
 		Predicate pred = Predicate();
 
-		pred.setName(tokens.at(0).getValue());
+		pred.setName(string(currentToken().getValue()));
 	  	match(TokenType::ID);
 	 	match(TokenType::LEFT_PAREN);
 
 		if (tokenType() == TokenType::ID)
 		{
-	  		pred.addParameter(Parameter(tokens.at(0).getValue()));
+	  		pred.addParameter(Parameter(string(currentToken().getValue())));
 	 		match(TokenType::ID);
 		}
 		idList(pred);
@@ -173,7 +180,7 @@ void idList(Predicate &pred) {
 	Predicate predicate()
 	{
 		Predicate pred = Predicate();
-		pred.setName(tokens.at(0).getValue());
+		pred.setName(string(currentToken().getValue()));
 	  	match(TokenType::ID);
 	 	match(TokenType::LEFT_PAREN);
 		parameter(pred);
@@ -183,34 +190,21 @@ void idList(Predicate &pred) {
 	}
 
 void predicateList(Rule& rule) {
-    if (tokenType() == TokenType::COMMA) {
+    while (tokenType() == TokenType::COMMA) {
         match(TokenType::COMMA); // Skips comments before comma
         rule.addBodyPredicate(predicate());
-        predicateList(rule);
     }
 }
 
-	void stringList(Predicate& pred)
-	{
-		if (tokenType() == TokenType::COMMA)
-		{
-			match(TokenType::COMMA);
-			pred.addParameter(Parameter(this->tokens.at(0).getValue()));
-			match(TokenType::STRING);
-			stringList(pred);
-
-		}
-	}
-
 	void parameter(Predicate& pred)
 	{
 		if (tokenType() == TokenType::STRING)
 		{
-			pred.addParameter(Parameter(tokens.at(0).getValue()));
+			pred.addParameter(Parameter(string(currentToken().getValue())));
 			match(TokenType::STRING);
 		}else if(tokenType() == TokenType::ID)
 			{
-			pred.addParameter(Parameter(tokens.at(0).getValue()));
+			pred.addParameter(Parameter(string(currentToken().getValue())));
 			match(TokenType::ID);
 			}
 			else{
@@ -220,11 +214,10 @@ void predicateList(Rule& rule) {
 
 	void parameterList(Predicate& pred)
 	{
-		if(tokenType() == TokenType::COMMA)
+		while(tokenType() == TokenType::COMMA)
 		{
 			match(TokenType::COMMA);
 			parameter(pred);
-			parameterList(pred);
 		}
 
 	}
@@ -266,7 +259,22 @@ void predicateList(Rule& rule) {
 		}
 		
 	}
-	DatalogProgram getDatalogProgram()
+	// A bare list of facts, as used for incremental updates. Returns false
+	// on a syntax error instead of exiting.
+	bool parseFacts()
+	{
+		try {
+			factList();
+			match(TokenType::END);
+		}
+		catch(Token& t)
+		{
+			return false;
+		}
+		return true;
+	}
+
+	DatalogProgram& getDatalogProgram()
 	{
 		return datalog;
 	}
@@ -19,7 +19,7 @@ public:
         name = newName;
     }
 
-    vector<Parameter> getParameters() const {
+    const vector<Parameter>& getParameters() const {
         return parameters;
     }
 
@@ -36,7 +36,7 @@ public:
     }
 
     void addParameter(Parameter param) {
-        parameters.push_back(param);
+        parameters.push_back(std::move(param));
     }
 
     string toString() const {
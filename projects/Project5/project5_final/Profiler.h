@@ -0,0 +1,122 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Per-rule timings for --profile. One record per (SCC, rule, pass); the
+// interpreter opens a record before evaluating a rule body and closes it
+// once the new tuples have been added.
+class Profiler
+{
+public:
+    enum Op { SCAN, JOIN, OP_COUNT }; // a scan selects, projects and renames at once
+
+    struct Record
+    {
+        int scc;
+        int rule;
+        int pass;
+        double seconds[OP_COUNT] = {};
+        size_t intermediateTuples = 0; // tuples produced by all operators
+        size_t maxIntermediate = 0;    // largest single operator output
+        size_t newTuples = 0;
+
+        double total() const
+        {
+            double sum = 0;
+            for (double s : seconds) sum += s;
+            return sum;
+        }
+    };
+
+private:
+    bool enabled = false;
+    vector<Record> records;
+    Record* current = nullptr;
+
+    static const char* opName(int op)
+    {
+        static const char* names[OP_COUNT] = {"scan", "join"};
+        return names[op];
+    }
+
+public:
+    Profiler() {}
+
+    void enable() { enabled = true; }
+    bool isEnabled() const { return enabled; }
+
+    void beginRule(int scc, int rule, int pass)
+    {
+        if (!enabled) return;
+        records.push_back(Record{scc, rule, pass});
+        current = &records.back();
+    }
+
+    void endRule(size_t newTuples)
+    {
+        if (!current) return;
+        current->newTuples = newTuples;
+        current = nullptr;
+    }
+
+    // Runs one relational operator, charging its time and output size to
+    // the open record. Returns the operator's result unchanged.
+    template <typename F>
+    auto measure(Op op, F&& f) -> decltype(f())
+    {
+        if (!current) return f();
+        auto start = chrono::steady_clock::now();
+        auto result = f();
+        current->seconds[op] += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        size_t size = result.size();
+        current->intermediateTuples += size;
+        current->maxIntermediate = max(current->maxIntermediate, size);
+        return result;
+    }
+
+    // Slowest records first
+    vector<Record> sorted() const
+    {
+        vector<Record> result = records;
+        stable_sort(result.begin(), result.end(),
+                    [](const Record& a, const Record& b) { return a.total() > b.total(); });
+        return result;
+    }
+
+    void printTable(ostream& out) const
+    {
+        out << left << setw(6) << "SCC" << setw(6) << "Rule" << setw(6) << "Pass";
+        for (int op = 0; op < OP_COUNT; op++) out << right << setw(11) << opName(op);
+        out << setw(11) << "total" << setw(14) << "interm" << setw(12) << "max" << setw(10) << "new" << "\n";
+        out << fixed << setprecision(6);
+        for (const Record& r : sorted())
+        {
+            out << left << setw(6) << r.scc << setw(6) << ("R" + to_string(r.rule)) << setw(6) << r.pass;
+            for (double s : r.seconds) out << right << setw(11) << s;
+            out << setw(11) << r.total() << setw(14) << r.intermediateTuples
+                << setw(12) << r.maxIntermediate << setw(10) << r.newTuples << "\n";
+        }
+    }
+
+    void printJSON(ostream& out) const
+    {
+        out << "[";
+        bool first = true;
+        for (const Record& r : sorted())
+        {
+            out << (first ? "\n" : ",\n") << "  {\"scc\": " << r.scc << ", \"rule\": " << r.rule
+                << ", \"pass\": " << r.pass;
+            for (int op = 0; op < OP_COUNT; op++) out << ", \"" << opName(op) << "\": " << r.seconds[op];
+            out << ", \"total\": " << r.total() << ", \"intermediateTuples\": " << r.intermediateTuples
+                << ", \"maxIntermediate\": " << r.maxIntermediate << ", \"newTuples\": " << r.newTuples << "}";
+            first = false;
+        }
+        out << "\n]\n";
+    }
+};
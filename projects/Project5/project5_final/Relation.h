@@ -4,29 +4,162 @@
 #include <sstream>
 #include "Scheme.h"
 #include "Tuple.h"
-#include <set>
+#include "TupleSet.h"
 #include <algorithm>
 #include <map>  
+#include <unordered_map>
+#include <mutex>
+#include "Arena.h"
+#include "ThreadPool.h"
 
 using namespace std; 
 
+// How Relation::join matches tuples on shared attributes. AUTO lets the
+// relation pick from the input sizes.
+enum JoinMethod { JOIN_AUTO, JOIN_HASH, JOIN_MERGE };
+
+class Relation;
+
+// A relation read under another scheme of the same arity. Lets a stored
+// relation be joined under a body literal's variable names without
+// copying it.
+struct RelationView {
+  const Relation* relation;
+  Scheme scheme;
+};
+
 class Relation {
  private:
   string name;
   Scheme scheme;
-  set<Tuple> tuples;
+  TupleSet tuples;
+
+  // Secondary indexes, column -> value -> row numbers in `tuples`, built
+  // the first time a column is selected on and kept up to date by addTuple
+  // and Union. Only relations that opt in get them (Database does for the
+  // ones it stores): intermediates and deltas are scanned once or twice and
+  // would not repay the build. Copies start without them to keep copying
+  // cheap.
+  typedef unordered_map<Symbol, vector<size_t>> ColumnIndex;
+  mutable unordered_map<size_t, ColumnIndex> indexes;
+  bool indexed = false;
+  mutable mutex indexLock; // readers on several threads may build indexes
+  static const size_t INDEX_MIN_SIZE = 64; // smaller relations just scan
+  static const size_t MERGE_MIN_SIZE = 1 << 16; // auto picks merge join above this
+  static const size_t PARALLEL_MIN_SIZE = 1 << 15; // smaller hash joins stay on one thread
+
+  void indexTuple(size_t row) {
+    for (auto& pair : indexes) pair.second[tuples[row][pair.first]].push_back(row);
+  }
+
+  const ColumnIndex& columnIndex(size_t column) const {
+    auto it = indexes.find(column);
+    if (it != indexes.end()) return it->second;
+    ColumnIndex& index = indexes[column];
+    for (size_t row = 0; row < tuples.size(); row++) index[tuples[row][column]].push_back(row);
+    return index;
+  }
+
+  // Rows that might satisfy the constants, or null to scan everything.
+  // Uses an existing index with the smallest bucket, else builds one on
+  // the first constant's column.
+  const vector<size_t>* candidates(const vector<pair<size_t, Symbol>>& constants) const {
+    if (!indexed || constants.empty() || tuples.size() < INDEX_MIN_SIZE) return nullptr;
+    lock_guard<mutex> guard(indexLock);
+    static const vector<size_t> none;
+    const vector<size_t>* best = nullptr;
+    for (const auto& c : constants) {
+      auto it = indexes.find(c.first);
+      if (it == indexes.end()) continue;
+      auto bucket = it->second.find(c.second);
+      if (bucket == it->second.end()) return &none;
+      if (!best || bucket->second.size() < best->size()) best = &bucket->second;
+    }
+    if (best) return best;
+    const ColumnIndex& index = columnIndex(constants[0].first);
+    auto bucket = index.find(constants[0].second);
+    return bucket == index.end() ? &none : &bucket->second;
+  }
 
  public:
   Relation() {}
   Relation(const string& name, const Scheme& scheme) : name(name), scheme(scheme) { }
+  // Tuples come from `resource`. The operators below build their results
+  // in Arena::current(), so inside an ArenaScope intermediates never touch
+  // the heap; stored relations copy what they are given.
+  Relation(const string& name, const Scheme& scheme, pmr::memory_resource* resource)
+      : name(name), scheme(scheme), tuples(resource) { }
+  Relation(const Relation& other) : name(other.name), scheme(other.scheme), tuples(other.tuples) { }
+  Relation(const Relation& other, pmr::memory_resource* resource)
+      : name(other.name), scheme(other.scheme), tuples(other.tuples, resource) { }
+  Relation(Relation&& other)
+      : name(std::move(other.name)), scheme(std::move(other.scheme)), tuples(std::move(other.tuples)),
+        indexes(std::move(other.indexes)), indexed(other.indexed) { }
+  Relation& operator=(const Relation& other) {
+    if (this != &other) {
+      name = other.name;
+      scheme = other.scheme;
+      tuples = other.tuples;
+      indexes.clear();
+    }
+    return *this;
+  }
+  Relation& operator=(Relation&& other) {
+    name = std::move(other.name);
+    scheme = std::move(other.scheme);
+    tuples = std::move(other.tuples);
+    indexes = std::move(other.indexes);
+    if (!indexed) indexes.clear();
+    return *this;
+  }
+
+  // Lets selections on constants build column indexes; assignment keeps
+  // the setting of the relation assigned to
+  void enableIndexes() { indexed = true; }
 
   bool addTuple(const Tuple& tuple) {
-    return tuples.insert(tuple).second; 
+    auto inserted = tuples.insert(tuple);
+    if (!inserted.second) return false;
+    if (!indexes.empty()) indexTuple(inserted.first);
+    return true; 
+  }
+
+  bool addTuple(Tuple&& tuple) {
+    auto inserted = tuples.insert(std::move(tuple));
+    if (!inserted.second) return false;
+    if (!indexes.empty()) indexTuple(inserted.first);
+    return true;
+  }
+
+  // Removes a tuple. The last row takes over its row number, so the
+  // indexes are patched rather than rebuilt.
+  bool eraseTuple(const Tuple& tuple) {
+    size_t row = tuples.find(tuple);
+    if (row == tuples.size()) return false;
+    size_t last = tuples.size() - 1;
+    for (auto& pair : indexes) {
+      ColumnIndex& index = pair.second;
+      Symbol value = tuple[pair.first];
+      vector<size_t>& bucket = index[value];
+      bucket.erase(find(bucket.begin(), bucket.end(), row));
+      if (row != last) {
+        vector<size_t>& moved = index[tuples[last][pair.first]];
+        *find(moved.begin(), moved.end(), last) = row;
+      }
+      if (index[value].empty()) index.erase(value);
+    }
+    tuples.eraseRow(row);
+    return true;
   }
 
 //select methods
-  Relation select(int index, const string& value) const {
-    Relation result(name, scheme);
+  Relation selectValue(int index, Symbol value) const {
+    Relation result(name, scheme, Arena::current());
+    const auto* matches = candidates({{static_cast<size_t>(index), value}});
+    if (matches) {
+      for (size_t row : *matches) result.addTuple(tuples[row]);
+      return result;
+    }
     for (const auto& tuple : tuples) {
       if (tuple[index] == value) result.addTuple(tuple);
     }
@@ -34,7 +167,7 @@ class Relation {
   }
 //select fro two indexes
   Relation select(int index1, int index2) const {
-    Relation result(name, scheme);
+    Relation result(name, scheme, Arena::current());
     for (const auto& tuple : tuples) {
       if (tuple[index1] == tuple[index2]) result.addTuple(tuple);
     }
@@ -46,22 +179,102 @@ class Relation {
     for (size_t colIndex : columns) 
       newScheme.push_back(scheme[colIndex]);
     
-    Relation result(name, newScheme);
+    Relation result(name, newScheme, Arena::current());
     for (const auto& tuple : tuples) {
-      vector<string> newValues;
+      Tuple newValues(result.tuples.resource());
+      newValues.reserve(columns.size());
       for (size_t colIndex : columns)
         newValues.push_back(tuple[colIndex]);
-      result.addTuple(Tuple(newValues));
+      result.addTuple(std::move(newValues));
+    }
+    return result;
+  }
+
+  // Fused select/project/rename: keep tuples matching every (column, value)
+  // and every (column, column) equality, emit the given columns under the
+  // new scheme. One pass, no intermediate relations.
+  Relation scan(const vector<pair<size_t, Symbol>>& constants,
+                const vector<pair<size_t, size_t>>& equalities,
+                const vector<size_t>& columns, const Scheme& newScheme) const& {
+    Relation result(name, newScheme, Arena::current());
+    bool identity = columns.size() == scheme.size();
+    for (size_t i = 0; identity && i < columns.size(); i++) identity = columns[i] == i;
+
+    auto emit = [&](const Tuple& tuple) {
+      if (identity) {
+        result.tuples.insert(tuple);
+        return;
+      }
+      Tuple projected(result.tuples.resource());
+      projected.reserve(columns.size());
+      for (size_t col : columns) projected.push_back(tuple[col]);
+      result.tuples.insert(std::move(projected));
+    };
+    auto matches = [&](const Tuple& tuple) {
+      for (const auto& c : constants) {
+        if (tuple[c.first] != c.second) return false;
+      }
+      for (const auto& e : equalities) {
+        if (tuple[e.first] != tuple[e.second]) return false;
+      }
+      return true;
+    };
+
+    // Point lookups go through a column index
+    if (const auto* subset = candidates(constants)) {
+      for (size_t row : *subset) {
+        if (matches(tuples[row])) emit(tuples[row]);
+      }
+      return result;
+    }
+
+    for (const auto& tuple : tuples) {
+      if (matches(tuple)) emit(tuple);
     }
     return result;
   }
 
-  Relation rename(const Scheme& newScheme) {
-    Relation result(name, newScheme);
+  // Same on a relation that is not needed afterwards. Without filters,
+  // when the columns are a permutation the tuples are reordered in place
+  // instead of copied.
+  Relation scan(const vector<pair<size_t, Symbol>>& constants,
+                const vector<pair<size_t, size_t>>& equalities,
+                const vector<size_t>& columns, const Scheme& newScheme) && {
+    if (!constants.empty() || !equalities.empty() || !isPermutation(columns)) {
+      return static_cast<const Relation&>(*this).scan(constants, equalities, columns, newScheme);
+    }
+    bool identity = true;
+    for (size_t i = 0; identity && i < columns.size(); i++) identity = columns[i] == i;
+    if (!identity) {
+      tuples.permute(columns);
+      indexes.clear();
+    }
+    return std::move(*this).rename(newScheme);
+  }
+
+  Relation rename(const Scheme& newScheme) const& {
+    Relation result(name, newScheme, Arena::current());
     result.tuples = tuples;
     return result;
   }
 
+  // Only the scheme changes; tuples and indexes are taken over as they are
+  Relation rename(const Scheme& newScheme) && {
+    scheme = newScheme;
+    return std::move(*this);
+  }
+
+  // Every column of this relation exactly once
+  bool isPermutation(const vector<size_t>& columns) const {
+    if (columns.size() != scheme.size()) return false;
+    vector<bool> seen(columns.size(), false);
+    for (size_t col : columns) {
+      if (col >= seen.size() || seen[col]) return false;
+      seen[col] = true;
+    }
+    return true;
+  }
+
   static bool joinable(const Scheme& leftScheme, const Scheme& rightScheme, 
                      const Tuple& leftTuple, const Tuple& rightTuple) {
     for (size_t leftIdx = 0; leftIdx < leftScheme.size(); leftIdx++) {
@@ -76,22 +289,34 @@ class Relation {
     return true;
   }
 
-  Relation join(const Relation& right) const {
-    const Relation& left = *this;
-    Scheme combinedScheme = left.scheme;
+  RelationView view(const Scheme& as) const { return RelationView{this, as}; }
+
+  Relation join(const Relation& right, JoinMethod method = JOIN_AUTO, ThreadPool* pool = nullptr) const {
+    return join(view(scheme), right.view(right.scheme), method, pool);
+  }
+
+  // Join two relations each read under the scheme of its view
+  static Relation join(const RelationView& leftView, const RelationView& rightView,
+                       JoinMethod method = JOIN_AUTO, ThreadPool* pool = nullptr) {
+    const Relation& left = *leftView.relation;
+    const Relation& right = *rightView.relation;
+    const Scheme& leftScheme = leftView.scheme;
+    const Scheme& rightScheme = rightView.scheme;
+    Scheme combinedScheme = leftScheme;
     vector<pair<size_t, size_t>> overlap; // Positions of overlapping attributes
 
     // Ident overlapping attributes
-    for (size_t i = 0; i < left.scheme.size(); i++) {
-        for (size_t j = 0; j < right.scheme.size(); j++) {
-            if (left.scheme[i] == right.scheme[j]) {
+    for (size_t i = 0; i < leftScheme.size(); i++) {
+        for (size_t j = 0; j < rightScheme.size(); j++) {
+            if (leftScheme[i] == rightScheme[j]) {
                 overlap.emplace_back(i, j);
             }
         }
     }
 
     // Add non-overlapping attributes from right
-    for (size_t j = 0; j < right.scheme.size(); j++) {
+    vector<size_t> rightExtra;
+    for (size_t j = 0; j < rightScheme.size(); j++) {
         bool isOverlap = false;
         for (const auto& pair : overlap) {
             if (j == pair.second) {
@@ -100,50 +325,251 @@ class Relation {
             }
         }
         if (!isOverlap) {
-            combinedScheme.push_back(right.scheme[j]);
+            combinedScheme.push_back(rightScheme[j]);
+            rightExtra.push_back(j);
         }
     }
 
-    // Join tuples
-    Relation result(left.name + "-" + right.name, combinedScheme);
-    for (const Tuple& lt : left.tuples) {
-        for (const Tuple& rt : right.tuples) {
-            bool canJoin = true;
-            for (const auto& pair : overlap) {
-                if (lt[pair.first] != rt[pair.second]) {
-                    canJoin = false;
-                    break;
-                }
-            }
-            if (canJoin) {
-                Tuple newTuple = lt;
-                for (size_t j = 0; j < rt.size(); j++) {
-                    bool isOverlap = false;
-                    for (const auto& pair : overlap) {
-                        if (j == pair.second) {
-                            isOverlap = true;
-                            break;
-                        }
-                    }
-                    if (!isOverlap) {
-                        newTuple.push_back(rt[j]);
-                    }
-                }
-                result.addTuple(newTuple);
-            }
-        }
+    Relation result(left.name + "-" + right.name, combinedScheme, Arena::current());
+    if (left.tuples.empty() || right.tuples.empty()) return result;
+
+    if (overlap.empty()) {
+        crossProduct(left, right, result);
+    } else if (chooseJoin(left.size(), right.size(), method) == JOIN_MERGE) {
+        mergeJoin(left, right, overlap, rightExtra, result);
+    } else if (pool && left.size() + right.size() >= PARALLEL_MIN_SIZE) {
+        partitionedHashJoin(left, right, overlap, rightExtra, result, *pool);
+    } else {
+        hashJoin(left, right, overlap, rightExtra, result);
     }
     return result;
 }
 
+  // Both inputs large and of similar size: a hash table on either side is
+  // about as big as the input, while merge join only sorts row numbers
+  static JoinMethod chooseJoin(size_t leftSize, size_t rightSize, JoinMethod method) {
+    if (method != JOIN_AUTO) return method;
+    size_t smaller = min(leftSize, rightSize);
+    size_t larger = max(leftSize, rightSize);
+    return smaller >= MERGE_MIN_SIZE && larger <= smaller * 4 ? JOIN_MERGE : JOIN_HASH;
+  }
+
+ private:
+  struct KeyHash {
+    size_t operator()(const vector<Symbol>& key) const {
+      size_t h = 0;
+      for (Symbol value : key)
+        h = h * 1000003 + value;
+      return h;
+    }
+  };
+
+  // Built straight in the memory of the set it is going into
+  static Tuple joinTuples(const Tuple& lt, const Tuple& rt, const vector<size_t>& rightExtra,
+                          pmr::memory_resource* resource) {
+    Tuple newTuple(resource);
+    newTuple.reserve(lt.size() + rightExtra.size());
+    newTuple.insert(newTuple.end(), lt.begin(), lt.end());
+    for (size_t j : rightExtra) newTuple.push_back(rt[j]);
+    return newTuple;
+  }
+
+  // No shared attributes: every pair matches
+  static void crossProduct(const Relation& left, const Relation& right, Relation& result) {
+    for (const Tuple& lt : left.tuples) {
+      for (const Tuple& rt : right.tuples) {
+        Tuple newTuple(result.tuples.resource());
+        newTuple.reserve(lt.size() + rt.size());
+        newTuple.insert(newTuple.end(), lt.begin(), lt.end());
+        newTuple.insert(newTuple.end(), rt.begin(), rt.end());
+        result.addTuple(std::move(newTuple));
+      }
+    }
+  }
+
+  // Build a table on the smaller side keyed by the overlapping columns,
+  // then probe it with each tuple of the other side
+  static void hashJoin(const Relation& left, const Relation& right,
+                       const vector<pair<size_t, size_t>>& overlap,
+                       const vector<size_t>& rightExtra, Relation& result) {
+    bool buildLeft = left.tuples.size() <= right.tuples.size();
+    const Relation& build = buildLeft ? left : right;
+    const Relation& probe = buildLeft ? right : left;
+
+    auto key = [&](const Tuple& t, bool isLeft) {
+      vector<Symbol> k;
+      k.reserve(overlap.size());
+      for (const auto& pair : overlap) k.push_back(t[isLeft ? pair.first : pair.second]);
+      return k;
+    };
+
+    unordered_map<vector<Symbol>, vector<const Tuple*>, KeyHash> table;
+    table.reserve(build.tuples.size());
+    for (const Tuple& t : build.tuples) table[key(t, buildLeft)].push_back(&t);
+
+    for (const Tuple& t : probe.tuples) {
+      auto it = table.find(key(t, !buildLeft));
+      if (it == table.end()) continue;
+      for (const Tuple* match : it->second) {
+        if (buildLeft) result.addTuple(joinTuples(*match, t, rightExtra, result.tuples.resource()));
+        else result.addTuple(joinTuples(t, *match, rightExtra, result.tuples.resource()));
+      }
+    }
+  }
+
+  // Hash join of one partition pair into a thread-local set
+  static void joinPartition(const vector<const Tuple*>& left, const vector<const Tuple*>& right,
+                            const vector<pair<size_t, size_t>>& overlap,
+                            const vector<size_t>& rightExtra, TupleSet& out) {
+    bool buildLeft = left.size() <= right.size();
+    const vector<const Tuple*>& build = buildLeft ? left : right;
+    const vector<const Tuple*>& probe = buildLeft ? right : left;
+
+    auto key = [&](const Tuple& t, bool isLeft) {
+      vector<Symbol> k;
+      k.reserve(overlap.size());
+      for (const auto& pair : overlap) k.push_back(t[isLeft ? pair.first : pair.second]);
+      return k;
+    };
+
+    unordered_map<vector<Symbol>, vector<const Tuple*>, KeyHash> table;
+    table.reserve(build.size());
+    for (const Tuple* t : build) table[key(*t, buildLeft)].push_back(t);
+
+    for (const Tuple* t : probe) {
+      auto it = table.find(key(*t, !buildLeft));
+      if (it == table.end()) continue;
+      for (const Tuple* match : it->second) {
+        out.insert(buildLeft ? joinTuples(*match, *t, rightExtra, out.resource())
+                             : joinTuples(*t, *match, rightExtra, out.resource()));
+      }
+    }
+  }
+
+  // Both sides are hash-partitioned on the join key, each worker scattering
+  // one slice of the input, and then every partition pair is joined on its
+  // own thread. An output tuple contains its join key, so two partitions
+  // can never produce the same tuple and the per-thread results are
+  // appended to the result without probing it for duplicates.
+  static void partitionedHashJoin(const Relation& left, const Relation& right,
+                                  const vector<pair<size_t, size_t>>& overlap,
+                                  const vector<size_t>& rightExtra, Relation& result, ThreadPool& pool) {
+    size_t threads = pool.size();
+    auto partitionOf = [&](const Tuple& t, bool isLeft) {
+      size_t h = 0;
+      for (const auto& pair : overlap) h = (h ^ t[isLeft ? pair.first : pair.second]) * 0x9E3779B97F4A7C15ULL;
+      return (h ^ (h >> 29)) % threads;
+    };
+
+    // scattered[worker][partition]
+    vector<vector<vector<const Tuple*>>> leftScattered(threads, vector<vector<const Tuple*>>(threads));
+    vector<vector<vector<const Tuple*>>> rightScattered(threads, vector<vector<const Tuple*>>(threads));
+    vector<TupleSet> outputs(threads); // filled on other threads, so on the heap, not in an arena
+
+    auto scatter = [&](size_t worker) {
+      for (size_t row = worker; row < left.size(); row += threads) {
+        const Tuple& t = left.tuples[row];
+        leftScattered[worker][partitionOf(t, true)].push_back(&t);
+      }
+      for (size_t row = worker; row < right.size(); row += threads) {
+        const Tuple& t = right.tuples[row];
+        rightScattered[worker][partitionOf(t, false)].push_back(&t);
+      }
+    };
+    auto joinOne = [&](size_t part) {
+      vector<const Tuple*> l, r;
+      for (size_t w = 0; w < threads; w++) {
+        l.insert(l.end(), leftScattered[w][part].begin(), leftScattered[w][part].end());
+        r.insert(r.end(), rightScattered[w][part].begin(), rightScattered[w][part].end());
+      }
+      joinPartition(l, r, overlap, rightExtra, outputs[part]);
+    };
+    pool.parallelFor(threads, scatter);
+    pool.parallelFor(threads, joinOne);
+
+    size_t total = 0;
+    for (const TupleSet& out : outputs) total += out.size();
+    result.tuples.reserve(total);
+    for (const TupleSet& out : outputs) result.tuples.appendDistinct(out);
+  }
+
+  // Sort row numbers of both sides by the join columns, then walk them
+  // together. Each run of equal keys on the left is paired with the run of
+  // equal keys on the right, so duplicate keys produce every combination.
+  static void mergeJoin(const Relation& left, const Relation& right,
+                        const vector<pair<size_t, size_t>>& overlap,
+                        const vector<size_t>& rightExtra, Relation& result) {
+    // <0, 0, >0 comparing the join key of a left tuple with a right tuple
+    auto compare = [&](const Tuple& lt, const Tuple& rt) {
+      for (const auto& pair : overlap) {
+        if (lt[pair.first] != rt[pair.second]) return lt[pair.first] < rt[pair.second] ? -1 : 1;
+      }
+      return 0;
+    };
+    auto sortedRows = [&](const Relation& rel, bool isLeft) {
+      vector<size_t> rows(rel.size());
+      for (size_t i = 0; i < rows.size(); i++) rows[i] = i;
+      sort(rows.begin(), rows.end(), [&](size_t a, size_t b) {
+        for (const auto& pair : overlap) {
+          size_t col = isLeft ? pair.first : pair.second;
+          if (rel.tuples[a][col] != rel.tuples[b][col]) return rel.tuples[a][col] < rel.tuples[b][col];
+        }
+        return false;
+      });
+      return rows;
+    };
+
+    vector<size_t> l = sortedRows(left, true);
+    vector<size_t> r = sortedRows(right, false);
+    size_t i = 0, j = 0;
+    while (i < l.size() && j < r.size()) {
+      const Tuple& lt = left.tuples[l[i]];
+      const Tuple& rt = right.tuples[r[j]];
+      int c = compare(lt, rt);
+      if (c < 0) { i++; continue; }
+      if (c > 0) { j++; continue; }
+
+      size_t iEnd = i + 1;
+      while (iEnd < l.size() && compare(left.tuples[l[iEnd]], rt) == 0) iEnd++;
+      size_t jEnd = j + 1;
+      while (jEnd < r.size() && compare(lt, right.tuples[r[jEnd]]) == 0) jEnd++;
+
+      for (size_t a = i; a < iEnd; a++) {
+        for (size_t b = j; b < jEnd; b++) {
+          result.addTuple(joinTuples(left.tuples[l[a]], right.tuples[r[b]], rightExtra, result.tuples.resource()));
+        }
+      }
+      i = iEnd;
+      j = jEnd;
+    }
+  }
+
+ public:
   //getters and Union method
   const string& getName() const { return name; }
   const Scheme& getScheme() const { return scheme; }
-  const set<Tuple>& getTuples() const { return tuples; }
+  const TupleSet& getTuples() const { return tuples; }
+  size_t size() const { return tuples.size(); }
+
+  // A temporary is taken over whole when there is nothing here yet
+  bool Union(Relation&& other) {
+    if (!tuples.empty() || !indexes.empty() || tuples.resource() != other.tuples.resource()) {
+      return Union(static_cast<const Relation&>(other));
+    }
+    if (other.tuples.empty()) return false;
+    tuples = std::move(other.tuples);
+    return true;
+  }
 
   bool Union(const Relation& other) {
+    if (!indexes.empty()) {
+      bool changed = false;
+      for (const auto& tuple : other.tuples) changed = addTuple(tuple) || changed;
+      return changed;
+    }
     size_t before = tuples.size();
-    tuples.insert(other.tuples.begin(), other.tuples.end());
-    return tuples.size() > before;
+    tuples.reserve(before + other.tuples.size());
+    for (const auto& tuple : other.tuples) tuples.insert(tuple);
+    return tuples.size() != before;
   }
 };
\ No newline at end of file
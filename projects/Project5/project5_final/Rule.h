@@ -15,12 +15,12 @@ public:
 
     void setHeadPredicate(Predicate predicate)
     {
-        this->headPredicate = predicate;
+        this->headPredicate = std::move(predicate);
     }
 
     void addBodyPredicate(Predicate predicate)
     {
-        this->bodyPredicates.push_back(predicate);
+        this->bodyPredicates.push_back(std::move(predicate));
     }
 
     const Predicate& getHeadPredicate() const {
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include "Token.h"
 #include <cctype>
 using namespace std;
@@ -7,7 +8,7 @@ using namespace std;
 class Scanner 
 {
 private:
-    string input;
+    string_view input; // not owned; must outlive the scanner and its tokens
     int line;
     size_t index;
 
@@ -44,15 +45,14 @@ private:
 
 Token ScanIdent()
     {
-	string ident;
+	size_t start = index;
 	int startline = line;
 
 	while (isalnum(currentChar()) || currentChar() == '_')
 	{
-	 ident += next();
-	//ident += currentChar(); 
-         // next();
+	 next();
 	}
+	string_view ident = input.substr(start, index - start);
 	
 	if (ident == "Schemes") return Token(TokenType::SCHEMES, ident,startline);
 	if (ident == "Facts") return Token(TokenType::FACTS, ident, startline);
@@ -64,21 +64,21 @@ Token ScanIdent()
 
  Token ScanComment()
  {
- 	string value = "#";
+ 	size_t start = index;
  	int startline = line; 
  	next();
  	while (currentChar() != '\n' && currentChar() != '\0')
  	{
- 	  value += next();
+ 	  next();
  	}
- 	return Token(TokenType::COMMENT,value,startline);
+ 	return Token(TokenType::COMMENT,input.substr(start, index - start),startline);
 
 
     }
 
 Token ScanString()
 {
-    string value = "'";
+    size_t start = index;
     int startline = line;
     next(); // Skip the opening quote
 
@@ -86,33 +86,30 @@ Token ScanString()
     {
         if (currentChar() == '\0') // End of input
         {
-            return Token(TokenType::UNDEFINED, value, startline);
+            return Token(TokenType::UNDEFINED, input.substr(start, index - start), startline);
         }
         else if (currentChar() == '\'')
         {
-            value += currentChar();
             next();
 
             if (currentChar() == '\'') // Escaped quote
             {
-                value += currentChar();
                 next();
             }
             else // End of string
             {
-                return Token(TokenType::STRING, value, startline);
+                return Token(TokenType::STRING, input.substr(start, index - start), startline);
             }
         }
         else
         {
-            value += currentChar();
             next();
         }
     }
 }
 
 public:
-    Scanner(const string &input) : input(input), line(1), index(0) {}
+    Scanner(string_view input) : input(input), line(1), index(0) {}
 
     Token scanTokens()
     {
@@ -149,7 +146,7 @@ public:
             case '\'': return ScanString();
 	    default: 
 		if (isalpha(c)) return ScanIdent();
-		string undefined_char(1,c);
+		string_view undefined_char = input.substr(index, 1);
 		next();
 		return Token(TokenType::UNDEFINED,undefined_char,line);
 
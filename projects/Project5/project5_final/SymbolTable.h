@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+typedef unsigned int Symbol;
+
+// Interns constants so tuples can hold fixed-width ids instead of strings.
+// Ids handed out in string order compare the same way the strings do; once
+// an out-of-order string is interned, comparisons fall back to the strings.
+class SymbolTable
+{
+private:
+    vector<string> names;
+    unordered_map<string, Symbol> ids;
+    bool ordered = true;
+
+public:
+    SymbolTable() {}
+
+    Symbol intern(const string& name)
+    {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        if (!names.empty() && name < names.back()) ordered = false;
+        Symbol id = static_cast<Symbol>(names.size());
+        names.push_back(name);
+        ids.emplace(name, id);
+        return id;
+    }
+
+    // False if the constant never appeared in the data
+    bool lookup(const string& name, Symbol& id) const
+    {
+        auto it = ids.find(name);
+        if (it == ids.end()) return false;
+        id = it->second;
+        return true;
+    }
+
+    const string& name(Symbol id) const { return names[id]; }
+    size_t size() const { return names.size(); }
+    bool isOrdered() const { return ordered; }
+
+    bool less(Symbol a, Symbol b) const
+    {
+        return ordered ? a < b : names[a] < names[b];
+    }
+
+    // Lexicographic order of two tuples by their strings
+    template <typename Values>
+    bool less(const Values& a, const Values& b) const
+    {
+        if (ordered) return a < b;
+        for (size_t i = 0; i < a.size() && i < b.size(); i++)
+        {
+            if (a[i] != b[i]) return names[a[i]] < names[b[i]];
+        }
+        return a.size() < b.size();
+    }
+};
@@ -0,0 +1,185 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Work-stealing scheduler shared by everything that runs in parallel. Each
+// worker has its own deque: it pushes and pops new tasks at the back, and
+// idle workers steal the oldest task from the front of someone else's.
+// Tasks submitted from outside the pool are dealt round-robin.
+//
+// Fork-join goes through TaskGroup, whose wait() runs queued tasks while
+// it waits, so a task may itself fork and wait (an SCC running a parallel
+// join, say) without tying up a worker.
+class ThreadPool
+{
+private:
+    struct Queue
+    {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<Queue>> queues; // one per worker
+    vector<thread> workers;
+    atomic<size_t> queued{0};
+    atomic<size_t> nextQueue{0};
+    mutex sleepLock;
+    condition_variable wake;
+    bool stopping = false;
+
+    // The pool and queue of the calling thread, if it is a worker
+    static ThreadPool*& currentPool()
+    {
+        static thread_local ThreadPool* pool = nullptr;
+        return pool;
+    }
+    static size_t& currentQueue()
+    {
+        static thread_local size_t index = 0;
+        return index;
+    }
+
+    bool take(size_t index, bool fromBack, function<void()>& task)
+    {
+        Queue& queue = *queues[index];
+        lock_guard<mutex> guard(queue.lock);
+        if (queue.tasks.empty()) return false;
+        if (fromBack)
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        queued--;
+        return true;
+    }
+
+    void work(size_t index)
+    {
+        currentPool() = this;
+        currentQueue() = index;
+        while (true)
+        {
+            if (runOne()) continue;
+            unique_lock<mutex> guard(sleepLock);
+            wake.wait(guard, [this] { return stopping || queued > 0; });
+            if (stopping && queued == 0) return;
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threads)
+    {
+        threads = max<size_t>(threads, 1);
+        for (size_t i = 0; i < threads; i++) queues.emplace_back(new Queue());
+        for (size_t i = 0; i < threads; i++) workers.emplace_back([this, i] { work(i); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            lock_guard<mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (thread& worker : workers) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    void submit(function<void()> task)
+    {
+        size_t index = currentPool() == this ? currentQueue() : nextQueue++ % queues.size();
+        {
+            lock_guard<mutex> guard(queues[index]->lock);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        queued++;
+        {
+            // Pairs with the predicate check in work() so a wakeup is not lost
+            lock_guard<mutex> guard(sleepLock);
+        }
+        wake.notify_one();
+    }
+
+    // Run one queued task on the calling thread: a worker's own newest
+    // task first, otherwise the oldest task of another queue. False if
+    // every queue was empty.
+    bool runOne()
+    {
+        function<void()> task;
+        bool worker = currentPool() == this;
+        size_t self = worker ? currentQueue() : 0;
+        bool found = worker && take(self, true, task);
+        for (size_t i = 1; !found && i <= queues.size(); i++)
+        {
+            found = take((self + i) % queues.size(), false, task);
+        }
+        if (!found) return false;
+        task();
+        return true;
+    }
+
+    // Calls f(i) for every i in [0, count), in chunks spread over the pool
+    void parallelFor(size_t count, const function<void(size_t)>& f);
+};
+
+// A set of forked tasks that can be joined
+class TaskGroup
+{
+private:
+    ThreadPool& pool;
+    atomic<size_t> outstanding{0};
+
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+    ~TaskGroup() { wait(); }
+
+    void run(function<void()> task)
+    {
+        outstanding++;
+        pool.submit([this, task = std::move(task)] {
+            task();
+            outstanding--;
+        });
+    }
+
+    // Helps with queued work until every task of this group has finished
+    void wait()
+    {
+        while (outstanding > 0)
+        {
+            if (!pool.runOne()) this_thread::yield();
+        }
+    }
+};
+
+inline void ThreadPool::parallelFor(size_t count, const function<void(size_t)>& f)
+{
+    size_t chunk = max<size_t>(1, count / (size() * 4));
+    TaskGroup group(*this);
+    for (size_t begin = 0; begin < count; begin += chunk)
+    {
+        size_t end = min(count, begin + chunk);
+        group.run([&f, begin, end] {
+            for (size_t i = begin; i < end; i++) f(i);
+        });
+    }
+    group.wait();
+}
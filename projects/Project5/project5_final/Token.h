@@ -2,6 +2,7 @@
 
 #include <sstream> 
 #include <string>
+#include <string_view>
 using namespace std;
 
 enum TokenType
@@ -30,14 +31,14 @@ class Token
 {
 	private:
 		TokenType type;
-		string value;
+		string_view value; // points into the scanner's source buffer
 		int line;
 
 public:
-	Token(TokenType type, const string& value, int line) : type(type), value(value), line(line) {}
+	Token(TokenType type, string_view value, int line) : type(type), value(value), line(line) {}
 	
     TokenType getType() const { return type; }
-    const string& getValue() const { return value; }
+    string_view getValue() const { return value; }
     int getLine() const { return line; }
 
 string toString() 
@@ -1,23 +1,37 @@
 #pragma once
 #include <iostream>
+#include <memory_resource>
 #include <vector>
 #include <sstream>
 #include "Scheme.h"
+#include "SymbolTable.h"
 #include <string>
 
 using namespace std;
 
-class Tuple: public vector<string>
+// Values come from a polymorphic allocator so that intermediate relations
+// can keep their tuples in an arena. Copies go to the heap unless a
+// resource is given, and a container with its own resource copies what
+// is inserted into it, so arena tuples never leak into stored relations.
+class Tuple: public pmr::vector<Symbol>
 {
 public:
-    Tuple(vector<string> values) : vector<string>(values) { }
+    Tuple() { }
+    explicit Tuple(const allocator_type& alloc) : pmr::vector<Symbol>(alloc) { }
+    Tuple(const std::vector<Symbol>& values) : pmr::vector<Symbol>(values.begin(), values.end()) { }
+    Tuple(const Tuple& other) = default;
+    Tuple(Tuple&& other) = default;
+    Tuple(const Tuple& other, const allocator_type& alloc) : pmr::vector<Symbol>(other, alloc) { }
+    Tuple(Tuple&& other, const allocator_type& alloc) : pmr::vector<Symbol>(std::move(other), alloc) { }
+    Tuple& operator=(const Tuple& other) = default;
+    Tuple& operator=(Tuple&& other) = default;
 
-    string toString(const Scheme& scheme) const
+    string toString(const Scheme& scheme, const SymbolTable& symbols) const
     {
         stringstream out;
         for (size_t i = 0; i < scheme.size(); i++)
         {
-            out << scheme[i] << "=" << (*this)[i];
+            out << scheme[i] << "=" << symbols.name((*this)[i]);
             if (i < scheme.size() - 1)
             {
                 out << ", ";
@@ -25,4 +39,4 @@ public:
         }
         return out.str();
     }
-};
\ No newline at end of file
+};
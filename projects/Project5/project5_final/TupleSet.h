@@ -0,0 +1,178 @@
+#pragma once
+#include <algorithm>
+#include <memory_resource>
+#include <vector>
+#include <utility>
+#include "Tuple.h"
+
+using namespace std;
+
+// Deduplicating tuple store: tuples live in a vector in insertion order and
+// an open-addressing table of row numbers (linear probing, power-of-two
+// size) finds duplicates. Row numbers are stable, so indexes can refer to
+// them. Iteration is in insertion order; callers that print sort first.
+// Rows, tuples and the table all come from one memory resource, the heap
+// unless the set is built in an arena.
+class TupleSet
+{
+private:
+    pmr::vector<Tuple> rows;
+    pmr::vector<size_t> slots; // row + 1, 0 = empty
+
+    static size_t hashTuple(const Tuple& tuple)
+    {
+        size_t h = tuple.size();
+        for (Symbol value : tuple) h = (h ^ value) * 0x9E3779B97F4A7C15ULL;
+        return h ^ (h >> 29);
+    }
+
+    // Slot holding an equal tuple, or the empty slot where it would go
+    size_t findSlot(const Tuple& tuple) const
+    {
+        size_t mask = slots.size() - 1;
+        size_t i = hashTuple(tuple) & mask;
+        while (slots[i] != 0 && rows[slots[i] - 1] != tuple) i = (i + 1) & mask;
+        return i;
+    }
+
+    // Puts a row known to be distinct from every other in the first empty
+    // slot of its probe sequence, without comparing tuples
+    void placeRow(size_t row)
+    {
+        size_t mask = slots.size() - 1;
+        size_t i = hashTuple(rows[row]) & mask;
+        while (slots[i] != 0) i = (i + 1) & mask;
+        slots[i] = row + 1;
+    }
+
+    void rehash(size_t capacity)
+    {
+        slots.assign(capacity, 0);
+        for (size_t row = 0; row < rows.size(); row++) placeRow(row);
+    }
+
+    template <typename T>
+    pair<size_t, bool> emplace(T&& tuple)
+    {
+        // Keep the load factor at or below one half
+        if ((rows.size() + 1) * 2 > slots.size()) rehash(slots.empty() ? 16 : slots.size() * 2);
+        size_t i = findSlot(tuple);
+        if (slots[i] != 0) return make_pair(slots[i] - 1, false);
+        rows.push_back(std::forward<T>(tuple));
+        slots[i] = rows.size();
+        return make_pair(rows.size() - 1, true);
+    }
+
+public:
+    typedef pmr::vector<Tuple>::const_iterator const_iterator;
+
+    TupleSet() {}
+    explicit TupleSet(pmr::memory_resource* resource) : rows(resource), slots(resource) {}
+    TupleSet(const TupleSet& other) = default;
+    TupleSet(TupleSet&& other) = default;
+    TupleSet(const TupleSet& other, pmr::memory_resource* resource)
+        : rows(other.rows, resource), slots(other.slots, resource) {}
+    TupleSet& operator=(const TupleSet& other) = default;
+    TupleSet& operator=(TupleSet&& other) = default;
+
+    pmr::memory_resource* resource() const { return rows.get_allocator().resource(); }
+
+    // (row number, true if newly inserted)
+    pair<size_t, bool> insert(const Tuple& tuple) { return emplace(tuple); }
+    pair<size_t, bool> insert(Tuple&& tuple) { return emplace(std::move(tuple)); }
+
+    // Appends the rows of another set without probing for duplicates. The
+    // caller guarantees no row of `other` is already here.
+    void appendDistinct(const TupleSet& other)
+    {
+        reserve(rows.size() + other.size());
+        for (const Tuple& tuple : other.rows)
+        {
+            rows.push_back(tuple);
+            placeRow(rows.size() - 1);
+        }
+    }
+
+    bool contains(const Tuple& tuple) const
+    {
+        return !slots.empty() && slots[findSlot(tuple)] != 0;
+    }
+
+    // Row number of an equal tuple, or size() if there is none
+    size_t find(const Tuple& tuple) const
+    {
+        if (slots.empty()) return rows.size();
+        size_t entry = slots[findSlot(tuple)];
+        return entry == 0 ? rows.size() : entry - 1;
+    }
+
+    // Removes one row. The last row moves into its place, so that row's
+    // number changes from size() - 1 to `row`.
+    void eraseRow(size_t row)
+    {
+        // Backward-shift deletion keeps every probe sequence unbroken
+        size_t mask = slots.size() - 1;
+        size_t hole = findSlot(rows[row]);
+        for (size_t j = (hole + 1) & mask; slots[j] != 0; j = (j + 1) & mask)
+        {
+            size_t home = hashTuple(rows[slots[j] - 1]) & mask;
+            bool movable = hole <= j ? (home <= hole || home > j) : (home <= hole && home > j);
+            if (movable)
+            {
+                slots[hole] = slots[j];
+                hole = j;
+            }
+        }
+        slots[hole] = 0;
+
+        size_t last = rows.size() - 1;
+        if (row != last)
+        {
+            slots[findSlot(rows[last])] = row + 1;
+            rows[row] = std::move(rows[last]);
+        }
+        rows.pop_back();
+    }
+
+    bool erase(const Tuple& tuple)
+    {
+        size_t row = find(tuple);
+        if (row == rows.size()) return false;
+        eraseRow(row);
+        return true;
+    }
+
+    // Reorders the values of every row in place: new column i is old
+    // column columns[i]. `columns` must be a permutation, so rows stay
+    // distinct and keep their numbers; only the table is rebuilt.
+    void permute(const vector<size_t>& columns)
+    {
+        vector<Symbol> values(columns.size());
+        for (Tuple& row : rows)
+        {
+            for (size_t i = 0; i < columns.size(); i++) values[i] = row[columns[i]];
+            copy(values.begin(), values.end(), row.begin());
+        }
+        if (!slots.empty()) rehash(slots.size());
+    }
+
+    void reserve(size_t count)
+    {
+        rows.reserve(count);
+        size_t capacity = slots.empty() ? 16 : slots.size();
+        while (capacity < count * 2) capacity *= 2;
+        if (capacity > slots.size()) rehash(capacity);
+    }
+
+    void clear()
+    {
+        rows.clear();
+        slots.clear();
+    }
+
+    const Tuple& operator[](size_t row) const { return rows[row]; }
+    size_t size() const { return rows.size(); }
+    bool empty() const { return rows.empty(); }
+    const_iterator begin() const { return rows.begin(); }
+    const_iterator end() const { return rows.end(); }
+};
@@ -0,0 +1,142 @@
+#pragma once
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Synthetic Datalog programs for the benchmark harness. Each generator
+// returns the full program text, including one query so the grammar is
+// satisfied.
+namespace Generators
+{
+    inline string quote(size_t value)
+    {
+        return "'" + to_string(value) + "'";
+    }
+
+    inline string edgeFacts(const vector<pair<size_t, size_t>>& edges)
+    {
+        stringstream ss;
+        for (const auto& e : edges) ss << " e(" << quote(e.first) << "," << quote(e.second) << ").\n";
+        return ss.str();
+    }
+
+    inline string transitiveClosure(const vector<pair<size_t, size_t>>& edges)
+    {
+        return "Schemes:\n e(a,b)\n path(a,b)\nFacts:\n" + edgeFacts(edges) +
+               "Rules:\n"
+               " path(X,Y) :- e(X,Y).\n"
+               " path(X,Z) :- e(X,Y),path(Y,Z).\n"
+               "Queries:\n path('0',X)?\n";
+    }
+
+    // 0 -> 1 -> ... -> n-1
+    inline string chainClosure(size_t n)
+    {
+        vector<pair<size_t, size_t>> edges;
+        for (size_t i = 0; i + 1 < n; i++) edges.emplace_back(i, i + 1);
+        return transitiveClosure(edges);
+    }
+
+    // Complete binary tree with n nodes, edges from parent to child
+    inline string treeClosure(size_t n)
+    {
+        vector<pair<size_t, size_t>> edges;
+        for (size_t i = 1; i < n; i++) edges.emplace_back((i - 1) / 2, i);
+        return transitiveClosure(edges);
+    }
+
+    // n nodes with the given average out-degree, fixed seed
+    inline string randomClosure(size_t n, size_t degree)
+    {
+        mt19937 rng(42);
+        uniform_int_distribution<size_t> node(0, n - 1);
+        vector<pair<size_t, size_t>> edges;
+        for (size_t i = 0; i < n * degree; i++) edges.emplace_back(node(rng), node(rng));
+        return transitiveClosure(edges);
+    }
+
+    // Same generation over a complete binary tree of n nodes
+    inline string sameGeneration(size_t n)
+    {
+        stringstream ss;
+        ss << "Schemes:\n par(c,p)\n sg(a,b)\nFacts:\n";
+        for (size_t i = 1; i < n; i++) ss << " par(" << quote(i) << "," << quote((i - 1) / 2) << ").\n";
+        ss << "Rules:\n"
+              " sg(X,Y) :- par(X,P),par(Y,P).\n"
+              " sg(X,Y) :- par(X,A),sg(A,B),par(Y,B).\n"
+              "Queries:\n sg('1',X)?\n";
+        return ss.str();
+    }
+
+    // Andersen-style points-to over n variables with about 2n statements
+    inline string pointsTo(size_t n)
+    {
+        mt19937 rng(7);
+        uniform_int_distribution<size_t> var(0, n - 1);
+        stringstream ss;
+        ss << "Schemes:\n addressOf(v,o)\n assign(v,w)\n load(v,p)\n store(p,v)\n pt(v,o)\nFacts:\n";
+        for (size_t i = 0; i < n / 2; i++) ss << " addressOf(" << quote(var(rng)) << "," << quote(var(rng)) << ").\n";
+        for (size_t i = 0; i < n; i++) ss << " assign(" << quote(var(rng)) << "," << quote(var(rng)) << ").\n";
+        for (size_t i = 0; i < n / 4; i++) ss << " load(" << quote(var(rng)) << "," << quote(var(rng)) << ").\n";
+        for (size_t i = 0; i < n / 4; i++) ss << " store(" << quote(var(rng)) << "," << quote(var(rng)) << ").\n";
+        ss << "Rules:\n"
+              " pt(V,O) :- addressOf(V,O).\n"
+              " pt(V,O) :- assign(V,W),pt(W,O).\n"
+              " pt(V,O) :- load(V,P),pt(P,Q),pt(Q,O).\n"
+              " pt(Q,O) :- store(P,V),pt(P,Q),pt(V,O).\n"
+              "Queries:\n pt('0',O)?\n";
+        return ss.str();
+    }
+
+    // Chain join across `width` relations of n random tuples each
+    inline string wideJoin(size_t n, size_t width)
+    {
+        mt19937 rng(11);
+        uniform_int_distribution<size_t> value(0, n - 1);
+        stringstream ss;
+        ss << "Schemes:\n";
+        for (size_t r = 0; r < width; r++) ss << " r" << r << "(a,b)\n";
+        ss << " w(a,b)\nFacts:\n";
+        for (size_t r = 0; r < width; r++)
+        {
+            for (size_t i = 0; i < n; i++) ss << " r" << r << "(" << quote(value(rng)) << "," << quote(value(rng)) << ").\n";
+        }
+        ss << "Rules:\n w(X0,X" << width << ") :- ";
+        for (size_t r = 0; r < width; r++)
+        {
+            ss << "r" << r << "(X" << r << ",X" << r + 1 << ")" << (r + 1 < width ? "," : ".\n");
+        }
+        ss << "Queries:\n w('0',X)?\n";
+        return ss.str();
+    }
+
+    // Triangles in a random graph: a cyclic three-way self-join
+    inline string triangles(size_t n, size_t degree)
+    {
+        mt19937 rng(5);
+        uniform_int_distribution<size_t> node(0, n - 1);
+        vector<pair<size_t, size_t>> edges;
+        for (size_t i = 0; i < n * degree; i++) edges.emplace_back(node(rng), node(rng));
+        return "Schemes:\n e(a,b)\n tri(a,b,c)\nFacts:\n" + edgeFacts(edges) +
+               "Rules:\n tri(X,Y,Z) :- e(X,Y),e(Y,Z),e(Z,X).\n"
+               "Queries:\n tri('0',Y,Z)?\n";
+    }
+
+    // Facts only, for scanner and parser throughput
+    inline string factsOnly(size_t n)
+    {
+        mt19937 rng(3);
+        uniform_int_distribution<size_t> value(0, n);
+        stringstream ss;
+        ss << "Schemes:\n f(a,b,c)\nFacts:\n";
+        for (size_t i = 0; i < n; i++)
+        {
+            ss << " f(" << quote(value(rng)) << "," << quote(value(rng)) << "," << quote(value(rng)) << ").\n";
+        }
+        ss << "Rules:\nQueries:\n f('0',X,Y)?\n";
+        return ss.str();
+    }
+}
@@ -0,0 +1,305 @@
+#include "../Scanner.h"
+#include "../Parser.h"
+#include "../Relation.h"
+#include "../Database.h"
+#include "../Interpreter.h"
+#include "Generators.h"
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Each case runs in a forked child so peak memory is measured per case.
+// setup() builds the input outside the timed region and before the peak is
+// reset, and returns the timed part, which reports how many tuples (or
+// tokens) it produced.
+typedef function<size_t()> Timed;
+typedef function<Timed()> Setup;
+
+struct Case
+{
+    string group;
+    string name;
+    size_t size;
+    Setup setup;
+};
+
+struct Result
+{
+    double seconds;
+    size_t tuples;
+    long peakKB; // growth of the child's peak RSS over its RSS after setup
+};
+
+// One "Vm...:" field of /proc/self/status, in KB
+static long statusKB(const string& field)
+{
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line))
+    {
+        if (line.compare(0, field.size(), field) == 0) return stol(line.substr(field.size()));
+    }
+    return 0;
+}
+
+// Starts VmHWM over from the current RSS, so the input built during setup
+// does not count toward the peak
+static void resetPeakRSS()
+{
+    ofstream("/proc/self/clear_refs") << "5";
+}
+
+static bool runIsolated(const Case& c, Result& result)
+{
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        Timed timed = c.setup();
+        resetPeakRSS();
+        long baseline = statusKB("VmRSS:");
+        auto start = chrono::steady_clock::now();
+        size_t tuples = timed();
+        Result r{chrono::duration<double>(chrono::steady_clock::now() - start).count(), tuples,
+                 statusKB("VmHWM:") - baseline};
+        ssize_t written = write(fds[1], &r, sizeof(r));
+        _exit(written == sizeof(r) ? 0 : 1);
+    }
+    close(fds[1]);
+    ssize_t n = read(fds[0], &result, sizeof(result));
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return n == sizeof(result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Number of distinct facts, so derived tuples can be told apart from loaded ones
+static size_t distinctFacts(const string& text)
+{
+    Scanner scanner(text);
+    Parser parser(scanner);
+    parser.parse();
+    set<string> facts;
+    for (const FactBatch& batch : parser.getDatalogProgram().getFactBatches())
+    {
+        for (size_t i = 0; i < batch.values.size(); i += batch.arity)
+        {
+            string key = batch.name;
+            for (size_t j = 0; j < batch.arity; j++) key += "," + string(batch.values[i + j]);
+            facts.insert(key);
+        }
+    }
+    return facts.size();
+}
+
+// Discards everything written to it, so the printed results do not count
+// toward a case's time or peak memory
+class NullBuffer : public streambuf
+{
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+// Scan, parse and evaluate a whole program with stdout discarded
+static Setup interpreterCase(function<string()> generate)
+{
+    return [generate]() -> Timed {
+        auto text = make_shared<string>(generate());
+        size_t facts = distinctFacts(*text);
+        return [text, facts]() -> size_t {
+            NullBuffer sink;
+            streambuf* old = cout.rdbuf(&sink);
+            Scanner scanner(*text);
+            Parser parser(scanner);
+            parser.parse();
+            Interpreter interpreter(std::move(parser.getDatalogProgram()));
+            interpreter.run();
+            cout.rdbuf(old);
+            return interpreter.getDatabase().tupleCount() - facts;
+        };
+    };
+}
+
+static Setup scannerCase(size_t n)
+{
+    return [n]() -> Timed {
+        auto text = make_shared<string>(Generators::factsOnly(n));
+        return [text]() -> size_t {
+            Scanner scanner(*text);
+            size_t tokens = 1;
+            while (scanner.scanTokens().getType() != TokenType::END) tokens++;
+            return tokens;
+        };
+    };
+}
+
+static Setup parserCase(size_t n)
+{
+    return [n]() -> Timed {
+        auto text = make_shared<string>(Generators::factsOnly(n));
+        return [text]() -> size_t {
+            Scanner scanner(*text);
+            Parser parser(scanner);
+            parser.parse();
+            size_t facts = 0;
+            for (const FactBatch& batch : parser.getDatalogProgram().getFactBatches()) facts += batch.size();
+            return facts;
+        };
+    };
+}
+
+static Relation randomRelation(const string& name, const Scheme& scheme, size_t n, size_t range, unsigned seed)
+{
+    mt19937 rng(seed);
+    uniform_int_distribution<Symbol> value(0, static_cast<Symbol>(range - 1));
+    Relation relation(name, scheme);
+    while (relation.size() < n)
+    {
+        vector<Symbol> values;
+        for (size_t i = 0; i < scheme.size(); i++) values.push_back(value(rng));
+        relation.addTuple(Tuple(values));
+    }
+    return relation;
+}
+
+// The partitioned join appends partition outputs without deduplicating
+// them, which is only right if no two partitions produce the same tuple.
+// Compared once with the serial hash join, on four partitions whatever
+// the machine has.
+static void checkPartitionedJoin(const Relation& lhs, const Relation& rhs)
+{
+    ThreadPool pool(4);
+    Relation serial = lhs.join(rhs, JOIN_HASH);
+    Relation partitioned = lhs.join(rhs, JOIN_HASH, &pool);
+    bool same = serial.size() == partitioned.size();
+    for (const Tuple& tuple : partitioned.getTuples()) same = same && serial.getTuples().contains(tuple);
+    if (!same) throw runtime_error("partitioned join differs from the serial hash join");
+}
+
+// One relational operator on random binary relations with n tuples
+static Setup operatorCase(const string& op, size_t n)
+{
+    return [op, n]() -> Timed {
+        auto lhs = make_shared<Relation>(randomRelation("l", Scheme({"A", "B"}), n, n, 1));
+        auto rhs = make_shared<Relation>(randomRelation("r", Scheme({"B", "C"}), n, n, 2));
+        // Started here so the timing does not include spawning the workers
+        shared_ptr<ThreadPool> pool;
+        if (op == "parallel-join")
+        {
+            pool = make_shared<ThreadPool>(thread::hardware_concurrency());
+            checkPartitionedJoin(*lhs, *rhs);
+        }
+        return [op, lhs, rhs, pool]() -> size_t {
+            if (op == "join") return lhs->join(*rhs, JOIN_HASH).size();
+            if (op == "merge-join") return lhs->join(*rhs, JOIN_MERGE).size();
+            if (op == "parallel-join") return lhs->join(*rhs, JOIN_HASH, pool.get()).size();
+            if (op == "select") return lhs->select(0, 1).size() + lhs->selectValue(0, 0).size();
+            if (op == "project") return lhs->project({1}).size();
+            return lhs->rename(Scheme({"X", "Y"})).size();
+        };
+    };
+}
+
+static vector<Case> allCases(size_t scale)
+{
+    vector<Case> cases;
+    for (size_t n : {10000, 100000, 500000})
+    {
+        cases.push_back({"scanner", "facts", n * scale, scannerCase(n * scale)});
+        cases.push_back({"parser", "facts", n * scale, parserCase(n * scale)});
+    }
+    for (size_t n : {10000, 100000, 1000000})
+    {
+        for (const char* op : {"select", "project", "rename", "join", "merge-join", "parallel-join"})
+        {
+            cases.push_back({"operator", op, n * scale, operatorCase(op, n * scale)});
+        }
+    }
+    for (size_t n : {50, 100, 200})
+    {
+        size_t s = n * scale;
+        cases.push_back({"interpreter", "tc-chain", s, interpreterCase([s] { return Generators::chainClosure(s); })});
+    }
+    for (size_t n : {255, 1023, 4095})
+    {
+        size_t s = n * scale;
+        cases.push_back({"interpreter", "tc-tree", s, interpreterCase([s] { return Generators::treeClosure(s); })});
+    }
+    for (size_t n : {100, 200, 400})
+    {
+        size_t s = n * scale;
+        cases.push_back({"interpreter", "tc-random", s, interpreterCase([s] { return Generators::randomClosure(s, 2); })});
+    }
+    for (size_t n : {63, 255, 1023})
+    {
+        size_t s = n * scale;
+        cases.push_back({"interpreter", "same-gen", s, interpreterCase([s] { return Generators::sameGeneration(s); })});
+    }
+    for (size_t n : {100, 200, 400})
+    {
+        size_t s = n * scale;
+        cases.push_back({"interpreter", "points-to", s, interpreterCase([s] { return Generators::pointsTo(s); })});
+    }
+    for (size_t n : {1000, 10000, 50000})
+    {
+        size_t s = n * scale;
+        cases.push_back({"interpreter", "wide-join", s, interpreterCase([s] { return Generators::wideJoin(s, 4); })});
+    }
+    for (size_t n : {500, 2000, 8000})
+    {
+        size_t s = n * scale;
+        cases.push_back({"interpreter", "triangle", s, interpreterCase([s] { return Generators::triangles(s, 8); })});
+    }
+    return cases;
+}
+
+int main(int argc, char* argv[])
+{
+    // bench [--scale N] [filter...]; a filter matches a group or case name
+    size_t scale = 1;
+    vector<string> filters;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--scale" && i + 1 < argc) scale = stoul(argv[++i]);
+        else filters.push_back(arg);
+    }
+
+    cout << left << setw(13) << "group" << setw(14) << "case" << right << setw(10) << "size"
+         << setw(12) << "seconds" << setw(12) << "tuples" << setw(14) << "tuples/sec" << setw(12) << "peak KB" << endl;
+    int failures = 0;
+    for (const Case& c : allCases(scale))
+    {
+        bool selected = filters.empty();
+        for (const string& f : filters) selected = selected || f == c.group || f == c.name;
+        if (!selected) continue;
+
+        Result r;
+        cout << left << setw(13) << c.group << setw(14) << c.name << right << setw(10) << c.size;
+        if (!runIsolated(c, r))
+        {
+            cout << "  failed" << endl;
+            failures++;
+            continue;
+        }
+        double rate = r.seconds > 0 ? r.tuples / r.seconds : 0;
+        cout << fixed << setprecision(4) << setw(12) << r.seconds << setw(12) << r.tuples
+             << setprecision(0) << setw(14) << rate << setw(12) << r.peakKB << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -5,54 +5,93 @@
 #include "Interpreter.h"
 #include "Node.h"
 #include "graph.h"
+#include "InputFile.h"
 #include <iostream>
-#include <fstream>
 #include <string>
+#include <cstdlib>
 
 using namespace std;
 
-string FiletoString(const string& path)
-{
-    ifstream input_file(path);
-    if (!input_file.is_open()) {
-        cerr << "Error opening file: " << path << endl;
-        return "";
-    }
-    return string((istreambuf_iterator<char>(input_file)), istreambuf_iterator<char>());
-}
 
 int main(int argc, char* argv[])
 {
+    // Options start with "--"; the remaining argument is the input file
+    string path;
+    bool semiNaive = true;
+    JoinMethod joinMethod = JOIN_AUTO;
+    bool reorderJoins = true;
+    bool leapfrog = true;
+    bool magicSets = false;
+    bool incremental = false;
+    size_t threads = 1;
+    bool parallelRules = false;
+    string profile; // "", "table" or "json"
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--naive") {
+            semiNaive = false;
+        } else if (arg == "--join=hash") {
+            joinMethod = JOIN_HASH;
+        } else if (arg == "--join=merge") {
+            joinMethod = JOIN_MERGE;
+        } else if (arg == "--join=auto") {
+            joinMethod = JOIN_AUTO;
+        } else if (arg == "--written-order") {
+            reorderJoins = false;
+        } else if (arg == "--no-leapfrog") {
+            leapfrog = false;
+        } else if (arg == "--magic") {
+            magicSets = true;
+        } else if (arg == "--incremental") {
+            incremental = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--parallel-rules") {
+            parallelRules = true;
+        } else if (arg == "--profile") {
+            profile = "table";
+        } else if (arg == "--profile=json") {
+            profile = "json";
+        } else {
+            path = arg;
+        }
+    }
+
     // Check if a file path was provided
-    if (argc < 2) {
+    if (path.empty()) {
         cerr << "no file provided" << endl;
         return 1;
     }
 
-    // Read file content
-    string input = FiletoString(argv[1]);
+    // Map the file (or read it, for pipes and "-" as stdin)
+    InputFile file(path);
+    if (!file.isOpen()) {
+        cerr << "Error opening file: " << path << endl;
+        return 1;
+    }
+    string_view input = file.view();
     if (input.empty()) {
         return 1; 
     }
 
-    // Scanner and Parser
+    // Scanner and Parser; the parser pulls tokens from the scanner as it goes
     Scanner scanner(input);
-    vector<Token> tokens;
-    Token token = scanner.scanTokens();
-    while (token.getType() != TokenType::END) {
-        tokens.push_back(token);
-        token = scanner.scanTokens();
-    }
-    tokens.push_back(token); // Add the END token
-
-    Parser parser(tokens);
+    Parser parser(scanner);
     parser.parse();
 
-    DatalogProgram datalogProgram = parser.getDatalogProgram();
+    DatalogProgram& datalogProgram = parser.getDatalogProgram();
 
     // Database and Interpreter
     Database database;
-        Interpreter interpreter(datalogProgram);
+        Interpreter interpreter(std::move(datalogProgram));
+    interpreter.setSemiNaive(semiNaive);
+    interpreter.setJoinMethod(joinMethod);
+    interpreter.setJoinReordering(reorderJoins);
+    interpreter.setLeapfrog(leapfrog);
+    interpreter.setMagicSets(magicSets);
+    interpreter.setThreads(threads);
+    interpreter.setParallelRules(parallelRules);
+    if (!profile.empty()) interpreter.enableProfiling();
     // interpreter.evaluateSchemes();
     // interpreter.evaluateFacts();
 
@@ -60,5 +99,39 @@ int main(int argc, char* argv[])
     // interpreter.evaluateQueries();
     interpreter.run();
 
+    // Incremental mode: stdin carries batches of fact changes separated by
+    // blank lines. A fact prefixed with "-" is retracted, any other is
+    // added; after each batch the queries are answered again.
+    if (incremental) {
+        string line, added, removed;
+        while (true) {
+            bool more = static_cast<bool>(getline(cin, line));
+            if (more && !line.empty()) {
+                if (line[0] == '-') {
+                    removed += line.substr(1) + "\n";
+                } else {
+                    added += line + "\n";
+                }
+                continue;
+            }
+            if (!added.empty() || !removed.empty()) {
+                Scanner addScanner(added), removeScanner(removed);
+                Parser addParser(addScanner), removeParser(removeScanner);
+                if (addParser.parseFacts() && removeParser.parseFacts()) {
+                    interpreter.update(addParser.getDatalogProgram(), removeParser.getDatalogProgram());
+                } else {
+                    cerr << "Invalid fact batch" << endl;
+                }
+                added.clear();
+                removed.clear();
+            }
+            if (!more) break;
+        }
+    }
+
+    // The report goes to stderr so stdout stays identical with or without it
+    if (profile == "table") interpreter.getProfiler().printTable(cerr);
+    if (profile == "json") interpreter.getProfiler().printJSON(cerr);
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,14 @@
+#!/bin/bash
+
+# script for the synthetic workload benchmarks
+# usage: ./run-bench.sh [--scale N] [group or case names...]
+
+program="bench_program"
+
+g++ -Wall -std=c++17 -O2 -pthread bench/benchmain.cpp -o $program || exit 1
+
+./$program "$@"
+status=$?
+
+rm $program
+exit $status
@@ -4,18 +4,28 @@
 
 program="project5"
 
-buckets="20 40 60 80 100"
+buckets="20 40 60 80 100 cyclic"
 
 numbers_20="21 22 23"
 numbers_40="41 42 43 44 45 46"
 numbers_60="61 62 64 66 67 68"
 numbers_80="81 82 83 84 85 86"
 numbers_100="101 102 103 104 105 108"
+numbers_cyclic="1"
+numbers_incremental="1 2"
 
 testdir="project5-passoff"
 diffopts=" -a -i -b -w -B "  # ignore whitespace
 
-g++ -Wall -std=c++17 -g *.cpp -o $program
+# other evaluation modes, each with the part of the output that must match
+# the answer: all of it, or only the query answers for modes that change
+# the rule evaluation section
+everything='p'
+queries='/^Query Evaluation/,$p'
+modes=("--naive" "--join=merge" "--no-leapfrog" "--magic" "--parallel-rules --threads 4")
+filters=("$everything" "$everything" "$everything" "$queries" "$queries")
+
+g++ -Wall -std=c++17 -g -pthread *.cpp -o $program
 
 for bucket in $buckets ; do
 
@@ -39,5 +49,51 @@ for bucket in $buckets ; do
     done
 done
 
+for i in "${!modes[@]}" ; do
+
+    mode=${modes[$i]}
+    filter=${filters[$i]}
+    echo Mode $mode
+
+    for bucket in $buckets ; do
+
+	eval numbers=\$numbers_$bucket
+
+	for number in $numbers ; do
+
+	    inputfile=$testdir/$bucket/input$number.txt
+	    answerfile=$testdir/$bucket/answer$number.txt
+	    outputfile=actual$number.txt
+
+	    ./$program $mode $inputfile | sed -n "$filter" > $outputfile
+
+	    sed -n "$filter" $answerfile | diff $diffopts - $outputfile || echo "diff failed on test" $number "with" $mode
+
+	    rm $outputfile
+
+	done
+    done
+done
+
+# incremental mode reads batches of fact changes from stdin and answers the
+# queries again after each one
+echo Incremental
+for number in $numbers_incremental ; do
+
+    echo "Running incremental input" $number
+
+    inputfile=$testdir/incremental/input$number.txt
+    updatefile=$testdir/incremental/updates$number.txt
+    answerfile=$testdir/incremental/answer$number.txt
+    outputfile=actual$number.txt
+
+    ./$program --incremental $inputfile < $updatefile > $outputfile
+
+    diff $diffopts $answerfile $outputfile || echo "diff failed on incremental test" $number
+
+    rm $outputfile
+
+done
+
 rm $program
 